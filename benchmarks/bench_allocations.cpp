@@ -0,0 +1,128 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include <new>
+#include <cstdlib>
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+
+using namespace timl;
+
+namespace {
+    std::size_t allocations = 0;
+    std::size_t allocated_bytes = 0;
+}
+
+//counts every heap allocation of the benchmark binary
+void* operator new(std::size_t sz)
+{
+    ++allocations;
+    allocated_bytes += sz;
+    if(void* p = std::malloc(sz ? sz : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+
+namespace {
+
+    //! allows the 100k items below, far outside defaultStreamReaderPolicy()
+    constexpr ValueSizePolicy allocation_policy()
+    { return {64, 1024*1024*64, 1024*1024*8, 1024*1024*65, 1024*1024, 1024*1024}; }
+
+    void decode(const std::string& name, const Value& document, KeyTable* keys = nullptr)
+    {
+        const std::string data = bench::encode(document);
+        const ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+        auto run = [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes, allocation_policy());
+            reader.setKeyTable(keys);
+            Value v;
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        };
+
+        const std::size_t before = allocations, bytes_before = allocated_bytes;
+        run();
+        std::cout << "  " << name << ": " << allocations - before << " allocations, "
+                  << (allocated_bytes - bytes_before) / 1024 << " KiB per decode\n";
+        bench::report(name, bench::time_per_iteration(50, run), data.size());
+    }
+
+    //! decodes \a count messages back to back into the same Value, the way a receive loop does
+    void decode_messages(const std::string& name, const std::string& data, std::size_t count, bool recycle)
+    {
+        const ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+        auto run = [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes);
+            reader.setRecycling(recycle);
+            Value v;
+            for(std::size_t i = 0; i < count; ++i)
+                if(not reader.getNextValue(v))
+                    std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        };
+        const std::size_t before = allocations;
+        run();
+        std::cout << "  " << name << ": " << double(allocations - before) / count << " allocations per message\n";
+        bench::report(name, bench::time_per_iteration(10, run), data.size());
+    }
+
+}
+
+void bench_allocations()
+{
+    Value array;
+    for(int i = 0; i < 100000; ++i)
+        array.push_back(i);
+    Value doc;
+    doc["items"] = std::move(array);
+    decode("100k item array", doc);
+
+    Value map;
+    for(int i = 0; i < 100000; ++i)
+        map["key_" + std::to_string(i)] = i;
+    decode("100k member Object", map);
+
+    //the same 20 keys over and over, each too long for std::string to keep inline
+    Value records;
+    for(int i = 0; i < 10000; ++i)
+    {
+        Value record;
+        for(int k = 0; k < 20; ++k)
+            record["record_field_number_" + std::to_string(k)] = i + k;
+        records.push_back(std::move(record));
+    }
+    Value log;
+    log["records"] = std::move(records);
+    decode("10k records of 20 keys", log);
+
+    KeyTable keys;
+    decode("10k records of 20 keys, interned", log, &keys);
+
+    std::string messages;
+    for(std::size_t i = 0; i < 10000; ++i)
+    {
+        Value message = log["records"][int(i)];
+        message["note"] = "message number " + std::to_string(i) + " of a receive loop";
+        messages += bench::encode(message);
+    }
+    decode_messages("10k messages into one Value", messages, 10000, false);
+    decode_messages("10k messages into one Value, recycled", messages, 10000, true);
+}
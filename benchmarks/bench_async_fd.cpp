@@ -0,0 +1,123 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "async_fd.hpp"
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+using namespace timl;
+
+namespace {
+
+    //! one end of a connection: writes a document, waits for its echo, and again, \a rounds times
+    struct Peer
+    {
+        Peer(EventLoop& loop, int fd) : reader(loop, fd, defaultStreamReaderPolicy(), 4096), writer(loop, fd) {}
+
+        void ping(const Value& message, std::size_t rounds)
+        {
+            if(rounds == 0)
+                return void(::shutdown(writer.fd(), SHUT_WR));
+            writer.write(message, [this, rounds, &message](IoStatus s) {
+                if(s != IoStatus::Ready)
+                    return;
+                reader.next(v, [this, rounds, &message](IoStatus r) {
+                    if(r == IoStatus::Ready)
+                    {
+                        ++echoed;
+                        ping(message, rounds - 1);
+                    }
+                });
+            });
+        }
+
+        void echo()
+        {
+            reader.next(v, [this](IoStatus s) {
+                if(s == IoStatus::Ready)
+                    writer.write(v, [this](IoStatus w) { if(w == IoStatus::Ready) echo(); });
+            });
+        }
+
+        AsyncReader reader;
+        AsyncWriter writer;
+        Value v;
+        std::size_t echoed = 0;
+    };
+
+    //! \a connections clients, each bouncing \a rounds messages off its own echo server, all on one EventLoop
+    void bench_echo(std::size_t connections, std::size_t rounds, const Value& message)
+    {
+        EventLoop loop;
+        std::vector<int> fds;
+        std::vector<std::unique_ptr<Peer>> clients, servers;
+        for(std::size_t i = 0; i < connections; ++i)
+        {
+            int pair[2];
+            if(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+            {
+                std::cerr << "socketpair failed after " << i << " connections" << std::endl;
+                break;
+            }
+            for(int fd : pair)
+            {
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+                fds.push_back(fd);
+            }
+            servers.emplace_back(new Peer(loop, pair[1]));
+            clients.emplace_back(new Peer(loop, pair[0]));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0; i < clients.size(); ++i)
+        {
+            servers[i]->echo();
+            clients[i]->ping(message, rounds);
+        }
+        loop.run();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::size_t echoed = 0;
+        for(auto& c : clients)
+            echoed += c->echoed;
+        for(int fd : fds)
+            ::close(fd);
+
+        const std::size_t size = bench::encode(message).size();
+        std::cout << "  " << clients.size() << " connections, " << size << " byte messages: " << echoed << " round trips, "
+                  << std::fixed << std::setprecision(0) << echoed / seconds << " messages/s\n";
+    }
+
+}
+
+void bench_async_fd()
+{
+    //each connection takes two fds
+    rlimit limit;
+    if(::getrlimit(RLIMIT_NOFILE, &limit) == 0 and limit.rlim_cur < 4096 and limit.rlim_max >= 4096)
+    {
+        limit.rlim_cur = 4096;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    Value small;
+    small["id"] = 42;
+    small["op"] = "ping";
+    bench_echo(1000, 100, small);
+    bench_echo(1000, 5, bench::tst_corpus(16*1024));
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "document.hpp"
+#include <chrono>
+#include <vector>
+
+using namespace timl;
+
+namespace {
+
+    //! decodes \a corpus into \a count Decoded, and returns the mean time it takes to destroy one of them
+    template<typename Decoded>
+    double teardown_time(const std::string& corpus, std::size_t count)
+    {
+        const ByteSpan span(reinterpret_cast<const byte*>(corpus.data()), corpus.size());
+        std::vector<Decoded> decoded(count);
+        for(Decoded& d : decoded)
+        {
+            ByteSpan bytes = span;
+            StreamReader<ByteSpan> reader(bytes);
+            if(not reader.getNextValue(d))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        decoded.clear();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return double(elapsed.count()) / count;
+    }
+
+}
+
+void bench_document()
+{
+    const std::string corpus = bench::encode(bench::tst_corpus(4*1024*1024));
+    const ByteSpan span(reinterpret_cast<const byte*>(corpus.data()), corpus.size());
+
+    auto ns = bench::time_per_iteration(10, [&]{
+        ByteSpan bytes = span;
+        StreamReader<ByteSpan> reader(bytes);
+        Value v;
+        if(not reader.getNextValue(v))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("4 MB of records, decode + destroy Value", ns, corpus.size());
+
+    Document doc;
+    ns = bench::time_per_iteration(10, [&]{
+        ByteSpan bytes = span;
+        StreamReader<ByteSpan> reader(bytes);
+        if(not reader.getNextValue(doc))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("4 MB of records, decode into reused Document", ns, corpus.size());
+
+    bench::report("4 MB of records, destroy Value", teardown_time<Value>(corpus, 5), corpus.size());
+    bench::report("4 MB of records, destroy Document", teardown_time<Document>(corpus, 5), corpus.size());
+
+    //small messages back to back, one document at a time
+    const std::size_t message_count = 20000;
+    const std::string message = bench::encode(bench::tst_document());
+    std::string messages;
+    for(std::size_t i = 0; i < message_count; ++i)
+        messages += message;
+    const ByteSpan message_span(reinterpret_cast<const byte*>(messages.data()), messages.size());
+
+    ns = bench::time_per_iteration(10, [&]{
+        ByteSpan bytes = message_span;
+        StreamReader<ByteSpan> reader(bytes);
+        for(std::size_t i = 0; i < message_count; ++i)
+        {
+            Value v;
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        }
+    });
+    bench::report(std::to_string(message_count) + " messages, fresh Value each", ns, messages.size());
+
+    ns = bench::time_per_iteration(10, [&]{
+        ByteSpan bytes = message_span;
+        StreamReader<ByteSpan> reader(bytes);
+        for(std::size_t i = 0; i < message_count; ++i)
+            if(not reader.getNextValue(doc))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report(std::to_string(message_count) + " messages, reused Document", ns, messages.size());
+}
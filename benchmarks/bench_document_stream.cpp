@@ -0,0 +1,58 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "document_stream.hpp"
+
+using namespace timl;
+
+void bench_document_stream()
+{
+    //a log of 20k small records, back to back
+    std::string log;
+    for(int i = 0; i < 20000; ++i)
+    {
+        Value record;
+        record["seq"] = i;
+        record["level"] = i % 7 == 0 ? "warn" : "info";
+        record["latency"] = 0.25 * (i % 400);
+        record["host"] = "node-17";
+        log += bench::encode(record);
+    }
+    const std::size_t iterations = 20;
+
+    auto ns = bench::time_per_iteration(iterations, [&]{
+        std::istringstream ss(log);
+        StreamReader<std::istringstream> reader(ss);
+        Value v;
+        while(not reader.atEnd())
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("20k records, getNextValue() loop", ns, log.size());
+
+    DocumentStreamStats stats{0, 0, 0};
+    ns = bench::time_per_iteration(iterations, [&]{
+        std::istringstream ss(log);
+        StreamReader<std::istringstream> reader(ss);
+        DocumentStream<std::istringstream> records(reader);
+        for(Value& v : records)
+            (void)v;
+        if(records.failed())
+            std::cerr << "decode failed: " << records.getLastError() << std::endl;
+        stats = records.stats();
+    });
+    bench::report("20k records, DocumentStream", ns, log.size());
+    std::cout << "  DocumentStream stats: " << stats.documents << " docs, " << stats.bytes << " bytes, "
+              << std::setprecision(0) << stats.documentsPerSecond() << " docs/s\n";
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include <vector>
+#include "bench_utils.hpp"
+#include "endian_kernels.hpp"
+
+using namespace timl;
+
+void bench_endian()
+{
+    //256 KiB stays in cache, so the kernels rather than memory bandwidth are measured
+    const std::size_t bytes = 256 * 1024;
+    std::vector<byte> src(bytes), dst(bytes);
+    for(std::size_t i = 0; i < bytes; ++i)
+        src[i] = static_cast<byte>(i);
+
+    std::cout << "  cpuid picks: " << endianKernels().name << "\n";
+    for(EndianIsa isa : {EndianIsa::Scalar, EndianIsa::SSE2, EndianIsa::SSSE3, EndianIsa::AVX2, EndianIsa::AVX512})
+    {
+        const EndianKernels* k = endianKernels(isa);
+        if(not k)
+            continue;
+        for(std::size_t size : {2, 4, 8})
+        {
+            auto swap = size == 2 ? k->swap16 : (size == 4 ? k->swap32 : k->swap64);
+            const double ns = bench::time_per_iteration(2000, [&]{
+                swap(src.data(), bytes / size, dst.data());
+            });
+            const std::string name = std::string(k->name) + ", " + std::to_string(size * 8) + " bit items";
+            std::cout << "  " << std::left << std::setw(48) << name << std::right
+                      << std::setw(12) << std::fixed << std::setprecision(1) << ns / 1000.0 << " us/iter"
+                      << std::setw(10) << std::setprecision(2) << bytes / ns << " GB/s\n";
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "lazy_value.hpp"
+#include "ubex_cursor.hpp"
+
+using namespace timl;
+
+//! A request with hundreds of members, of which a gateway only reads three, then forwards the rest
+void bench_lazy_value()
+{
+    Value request;
+    request["id"] = 1234567;
+    request["route"] = "/api/v1/orders";
+    for(int i = 0; i < 300; ++i)
+        request["field_" + std::to_string(i)] = bench::tst_document();
+    request["tenant"] = "acme";
+    const std::string data = bench::encode(request);
+    const ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+    std::cout << "  document: " << data.size() << " bytes, " << request.size() << " members, 3 of them read\n";
+
+    const std::size_t iterations = 200;
+    volatile std::size_t sink = 0;     //keeps the reads from being optimized away
+    auto ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        reader.getNextValue(v);
+        sink = v["id"].asInt64() + v["route"].asString().size() + v["tenant"].asString().size();
+    });
+    bench::report("BufferReader, full decode", ns, data.size());
+
+    ns = bench::time_per_iteration(iterations, [&]{
+        LazyValue v(span);
+        sink = v["id"].asInt64() + v["route"].asString().size() + v["tenant"].asString().size();
+    });
+    bench::report("LazyValue, shallow scan", ns, data.size());
+
+    //the same document, with every Object announcing its width
+    const std::string hinted = bench::encode(request, StreamWriterOptions{true});
+    const ByteSpan hinted_span(reinterpret_cast<const byte*>(hinted.data()), hinted.size());
+    ns = bench::time_per_iteration(iterations, [&]{
+        LazyValue v(hinted_span);
+        sink = v["id"].asInt64() + v["route"].asString().size() + v["tenant"].asString().size();
+    });
+    bench::report("LazyValue, shallow scan, Width hints", ns, hinted.size());
+
+    for(const std::string* bytes : {&data, &hinted})
+    {
+        const ByteSpan doc(reinterpret_cast<const byte*>(bytes->data()), bytes->size());
+        ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan b = doc;
+            BufferReader reader(b);
+            BufferCursor cursor(reader);
+            std::size_t total = 0;
+            cursor.next();
+            while(cursor.next() != Token::ObjectEnd)
+            {
+                if(cursor.key() == "id")
+                    total += cursor.asInt64();
+                else if(cursor.token() == Token::String)
+                    total += cursor.asString().size();
+                else
+                    cursor.skip();
+            }
+            sink = total;
+        });
+        bench::report(bytes == &data ? "BufferCursor, skipping" : "BufferCursor, skipping, Width hints", ns, bytes->size());
+    }
+}
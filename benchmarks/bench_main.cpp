@@ -0,0 +1,83 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include <iostream>
+
+extern void bench_buffered_reader();
+extern void bench_blob_reader();
+extern void bench_lazy_value();
+extern void bench_nesting();
+extern void bench_scalars();
+extern void bench_allocations();
+extern void bench_numeric_arrays();
+extern void bench_endian();
+extern void bench_document_stream();
+extern void bench_parallel();
+extern void bench_parallel_arrays();
+extern void bench_validate();
+extern void bench_push_parser();
+extern void bench_async_fd();
+extern void bench_size_policy();
+extern void bench_document();
+
+int main()
+{
+    std::cout << "Buffered StreamReader vs. one stream read per primitive\n";
+    bench_buffered_reader();
+
+    std::cout << "\nBlob-heavy documents\n";
+    bench_blob_reader();
+
+    std::cout << "\nReading a few members of a large document\n";
+    bench_lazy_value();
+
+    std::cout << "\nDeep and wide documents\n";
+    bench_nesting();
+
+    std::cout << "\nScalar-heavy documents\n";
+    bench_scalars();
+
+    std::cout << "\nAllocations while decoding\n";
+    bench_allocations();
+
+    std::cout << "\nHomogenous numeric Arrays\n";
+    bench_numeric_arrays();
+
+    std::cout << "\nEndian conversion kernels\n";
+    bench_endian();
+
+    std::cout << "\nStreams of documents\n";
+    bench_document_stream();
+
+    std::cout << "\nDecoding documents in parallel\n";
+    bench_parallel();
+
+    std::cout << "\nDecoding the large Arrays of a document in parallel\n";
+    bench_parallel_arrays();
+
+    std::cout << "\nValidating without decoding\n";
+    bench_validate();
+
+    std::cout << "\nDecoding bytes as they arrive\n";
+    bench_push_parser();
+
+    std::cout << "\nEchoing over non-blocking sockets\n";
+    bench_async_fd();
+
+    std::cout << "\nRun time, static and unchecked size limits\n";
+    bench_size_policy();
+
+    std::cout << "\nDecoding into an arena-backed Document\n";
+    bench_document();
+    return 0;
+}
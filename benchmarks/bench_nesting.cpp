@@ -0,0 +1,77 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "event_handler.hpp"
+
+using namespace timl;
+
+namespace {
+
+    //! allows the documents below; both are far outside defaultStreamReaderPolicy()
+    constexpr ValueSizePolicy nesting_policy()
+    { return {2048, 1024*1024*64, 1024*1024*8, 1024*1024*65, 1024*1024, 1024*1024}; }
+
+    void decode(const std::string& name, const std::string& data)
+    {
+        const ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+        const std::size_t iterations = 200;
+
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes, nesting_policy());
+            BasicHandler handler;
+            if(not reader.parse(handler))
+                std::cerr << "parse failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name + ", parse()", ns, data.size());
+
+        ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes, nesting_policy());
+            Value v;
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name + ", getNextValue()", ns, data.size());
+    }
+
+}
+
+void bench_nesting()
+{
+    Value deep;
+    deep["leaf"] = "bottom";
+    for(int level = 999; level > 0; --level)
+    {
+        Value parent;
+        parent["level"] = level;
+        parent["items"] = {level, -level, 0.5};
+        parent["next"] = std::move(deep);
+        deep = std::move(parent);
+    }
+    decode("depth 1000", bench::encode(deep));
+
+    Value items;
+    for(int i = 0; i < 50000; ++i)
+    {
+        Value item;
+        item["id"] = i;
+        item["score"] = i * 0.5;
+        items.push_back(std::move(item));
+    }
+    Value wide;
+    wide["items"] = std::move(items);
+    decode("50k item array", bench::encode(wide));
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include <cmath>
+#include <cstring>
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "event_handler.hpp"
+#include "ubex_cursor.hpp"
+
+using namespace timl;
+
+namespace {
+
+    const std::size_t channels = 4;
+    const std::size_t samples = 16384;
+
+    //! a telemetry frame of 4 channels, each a homogenous Array of 16k Float32 samples
+    std::string telemetry_frame()
+    {
+        std::string data = {'{', 'I', static_cast<char>(channels)};
+        for(std::size_t c = 0; c < channels; ++c)
+        {
+            data += {3, 'c', 'h', static_cast<char>('0' + c), '(', 'd', 'K'};
+            for(int shift = 24; shift >= 0; shift -= 8)
+                data += static_cast<char>(samples >> shift);
+            for(std::size_t i = 0; i < samples; ++i)
+            {
+                const float sample = static_cast<float>(std::sin(0.001 * i) * (c + 1));
+                uint32_t bits;
+                std::memcpy(&bits, &sample, sizeof(bits));
+                for(int shift = 24; shift >= 0; shift -= 8)
+                    data += static_cast<char>(bits >> shift);
+            }
+            data += ')';
+        }
+        data += '}';
+        return data;
+    }
+
+    //! the samples of telemetry_frame(), and 4 channels of 16k small integer counters
+    Value telemetry_value()
+    {
+        Value frame;
+        for(std::size_t c = 0; c < channels; ++c)
+        {
+            Value floats, counters;
+            for(std::size_t i = 0; i < samples; ++i)
+            {
+                floats.push_back(static_cast<float>(std::sin(0.001 * i) * (c + 1)));
+                counters.push_back(static_cast<int>((i * 37 + c) % 1000));
+            }
+            frame[std::string("ch") + char('0' + c)] = std::move(floats);
+            frame[std::string("n") + char('0' + c)] = std::move(counters);
+        }
+        return frame;
+    }
+
+    //! a ValueBuilder that takes every number one by one
+    struct ItemwiseBuilder : ValueBuilder
+    {
+        using ValueBuilder::ValueBuilder;
+    };
+
+}
+
+namespace timl {
+    template<>
+    struct handler_traits<ItemwiseBuilder>
+    {
+        static constexpr bool owns_sequences = true;
+        static constexpr bool bulk_numbers = false;
+    };
+}
+
+void bench_numeric_arrays()
+{
+    const std::string data = telemetry_frame();
+    const ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+    const std::size_t iterations = 100;
+
+    auto ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        ItemwiseBuilder builder(v);
+        if(not reader.parse(builder))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("4x16k Float32, Value item by item", ns, data.size());
+
+    ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        if(not reader.getNextValue(v))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("4x16k Float32, getNextValue()", ns, data.size());
+
+    std::vector<float> out;
+    out.reserve(samples);
+    ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        BufferCursor cursor(reader);
+        volatile float sink = 0;
+        while(cursor.next() != Token::End)
+            if(cursor.token() == Token::Float)
+                sink = static_cast<float>(cursor.asFloat());
+        (void)sink;
+    });
+    bench::report("4x16k Float32, cursor item by item", ns, data.size());
+
+    ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        BufferCursor cursor(reader);
+        volatile float sink = 0;
+        while(cursor.next() != Token::End)
+            if(cursor.readNumbers(out))
+                sink = out.back();
+        (void)sink;
+    });
+    bench::report("4x16k Float32, cursor readNumbers()", ns, data.size());
+
+    const Value frame = telemetry_value();
+    const std::string encoded = bench::encode(frame);
+    std::cout << "  4x16k Float32 + 4x16k counters, encoded size        " << encoded.size() << " bytes\n";
+    ns = bench::time_per_iteration(iterations, [&]{
+        volatile std::size_t sink = bench::encode(frame).size();
+        (void)sink;
+    });
+    bench::report("4x16k Float32 + 4x16k counters, StreamWriter", ns, encoded.size());
+
+    const ByteSpan encoded_span(reinterpret_cast<const byte*>(encoded.data()), encoded.size());
+    ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = encoded_span;
+        BufferReader reader(bytes);
+        BasicHandler handler;
+        if(not reader.parse(handler))
+            std::cerr << "parse failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("4x16k Float32 + 4x16k counters, parse()", ns, encoded.size());
+}
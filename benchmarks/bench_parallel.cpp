@@ -0,0 +1,55 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include <thread>
+#include "bench_utils.hpp"
+#include "parallel_document_reader.hpp"
+
+using namespace timl;
+
+void bench_parallel()
+{
+    //a log of 20k records of a few hundred bytes each
+    std::string log;
+    const Value record = bench::tst_document();
+    for(int i = 0; i < 20000; ++i)
+        log += bench::encode(record);
+    const ByteSpan span(reinterpret_cast<const byte*>(log.data()), log.size());
+    const std::size_t iterations = 5;
+
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    auto ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        while(not reader.atEnd())
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("20k records, one thread", ns, log.size());
+
+    for(bool ordered : {true, false})
+        for(std::size_t threads : {1, 2, 4, 8, 16})
+        {
+            ns = bench::time_per_iteration(iterations, [&]{
+                ParallelDocumentReader reader(span, ParallelReaderOptions{threads, ordered});
+                Value v;
+                while(reader.next(v)) {}
+                if(reader.failed())
+                    std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+            });
+            const std::string name = "20k records, " + std::to_string(threads) + " threads"
+                                   + (ordered ? ", ordered" : ", unordered");
+            bench::report(name, ns, log.size());
+        }
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "parallel_value_decoder.hpp"
+
+using namespace timl;
+
+void bench_parallel_arrays()
+{
+    //a single document holding one Array of 500k small records
+    Value capture;
+    capture["source"] = "probe";
+    for(int i = 0; i < 500000; ++i)
+    {
+        Value sample;
+        sample["t"] = i;
+        sample["v"] = i * 0.5;
+        sample["ok"] = i % 2 == 0;
+        capture["samples"].push_back(std::move(sample));
+    }
+    const std::string doc = bench::encode(capture);
+    capture = Value();
+    const ByteSpan span(reinterpret_cast<const byte*>(doc.data()), doc.size());
+    const std::size_t iterations = 3;
+
+    auto ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        if(not reader.getNextValue(v))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("500k item Array, getNextValue()", ns, doc.size());
+
+    for(std::size_t threads : {1, 2, 4, 8})
+    {
+        ns = bench::time_per_iteration(iterations, [&]{
+            ParallelValueDecoder decoder(ParallelDecodeOptions{threads, 64*1024});
+            Value v;
+            if(not decoder.decode(span, v))
+                std::cerr << "decode failed: " << decoder.getLastError() << std::endl;
+        });
+        bench::report("500k item Array, " + std::to_string(threads) + " threads", ns, doc.size());
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "push_parser.hpp"
+
+using namespace timl;
+
+void bench_push_parser()
+{
+    const std::string doc = bench::encode(bench::tst_corpus(4*1024*1024));
+    const ByteSpan span(reinterpret_cast<const byte*>(doc.data()), doc.size());
+
+    auto ns = bench::time_per_iteration(5, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        if(not reader.getNextValue(v))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("4 MB of records, BufferReader, whole", ns, doc.size());
+
+    //the sizes recv() would hand out: a byte at a time, an Ethernet frame, a socket buffer
+    for(std::size_t fragment : {1, 1500, 64*1024})
+    {
+        ns = bench::time_per_iteration(5, [&]{
+            PushParser parser;
+            PushParser::Progress p{PushParser::NeedMore, 0};
+            for(std::size_t at = 0; at < doc.size() and p.status == PushParser::NeedMore; at += fragment)
+                p = parser.feed(span.subspan(at, fragment));
+            if(p.status != PushParser::Complete)
+                std::cerr << "push parsing failed: " << parser.getLastError() << std::endl;
+        });
+        bench::report("4 MB of records, PushParser, " + std::to_string(fragment) + " B fragments", ns, doc.size());
+    }
+}
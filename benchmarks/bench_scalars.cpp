@@ -0,0 +1,90 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "event_handler.hpp"
+#include "lazy_value.hpp"
+
+using namespace timl;
+
+namespace {
+
+    //! 200k scalars of every scalar marker, in a pseudo random order no branch predictor learns
+    Value scalar_corpus()
+    {
+        Value scalars;
+        unsigned long long state = 42;
+        for(long long i = 0; i < 200000; ++i)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            switch ((state >> 33) % 12) {
+            case 0: scalars.push_back(Value()); break;
+            case 1: scalars.push_back(i % 24 == 1); break;
+            case 2: scalars.push_back(static_cast<char>('a' + i % 26)); break;
+            case 3: scalars.push_back(i % 200); break;
+            case 4: scalars.push_back(-(i % 100)); break;
+            case 5: scalars.push_back(-1000 - i); break;
+            case 6: scalars.push_back(60000 + i); break;
+            case 7: scalars.push_back(-70000 * i); break;
+            case 8: scalars.push_back(5000000000ll + i); break;
+            case 9: scalars.push_back(0.5 * i); break;
+            case 10: scalars.push_back(1.0 / (i + 1)); break;
+            default: scalars.push_back(static_cast<unsigned long long>(i) << 40); break;
+            }
+        }
+        Value corpus;
+        corpus["scalars"] = std::move(scalars);
+        return corpus;
+    }
+
+}
+
+void bench_scalars()
+{
+    const Value corpus = scalar_corpus();
+    const std::string data = bench::encode(corpus);
+    const ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+    const std::size_t iterations = 200;
+
+    auto ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        BasicHandler handler;
+        if(not reader.parse(handler))
+            std::cerr << "parse failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("200k scalars, parse()", ns, data.size());
+
+    ns = bench::time_per_iteration(iterations, [&]{
+        ByteSpan bytes = span;
+        BufferReader reader(bytes);
+        Value v;
+        if(not reader.getNextValue(v))
+            std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+    });
+    bench::report("200k scalars, getNextValue()", ns, data.size());
+
+    ns = bench::time_per_iteration(iterations, [&]{
+        LazyValue doc(span);
+        volatile std::size_t sink = doc.size();
+        (void)sink;
+    });
+    bench::report("200k scalars, skipped by LazyValue", ns, data.size());
+
+    ns = bench::time_per_iteration(iterations, [&]{
+        volatile std::size_t sink = bench::encode(corpus).size();
+        (void)sink;
+    });
+    bench::report("200k scalars, StreamWriter", ns, data.size());
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "event_handler.hpp"
+#include <sstream>
+
+using namespace timl;
+
+namespace {
+
+    template<typename SizePolicy>
+    void bench_policy(const std::string& name, const std::string& corpus, const std::string& messages,
+                      std::size_t message_count)
+    {
+        const ByteSpan span(reinterpret_cast<const byte*>(corpus.data()), corpus.size());
+
+        auto ns = bench::time_per_iteration(10, [&]{
+            ByteSpan bytes = span;
+            StreamReader<ByteSpan, SizePolicy> reader(bytes);
+            BasicHandler handler;
+            if(not reader.parse(handler))
+                std::cerr << "parse failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report("4 MB of records, parse(), " + name, ns, corpus.size());
+
+        ns = bench::time_per_iteration(10, [&]{
+            ByteSpan bytes = span;
+            StreamReader<ByteSpan, SizePolicy> reader(bytes);
+            Value v;
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report("4 MB of records, getNextValue(), " + name, ns, corpus.size());
+
+        //small messages back to back, as a peer on loopback sends them
+        ns = bench::time_per_iteration(10, [&]{
+            std::istringstream ss(messages);
+            StreamReader<std::istringstream, SizePolicy> reader(ss, defaultSizePolicy<SizePolicy>(), 4096);
+            Value v;
+            for(std::size_t i = 0; i < message_count; ++i)
+                if(not reader.getNextValue(v))
+                    std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(std::to_string(message_count) + " messages, getNextValue(), " + name, ns, messages.size());
+    }
+
+}
+
+void bench_size_policy()
+{
+    const std::string corpus = bench::encode(bench::tst_corpus(4*1024*1024));
+
+    const std::size_t message_count = 20000;
+    const std::string message = bench::encode(bench::tst_document());
+    std::string messages;
+    for(std::size_t i = 0; i < message_count; ++i)
+        messages += message;
+
+    bench_policy<ValueSizePolicy>("run time limits", corpus, messages, message_count);
+    bench_policy<DefaultStaticSizePolicy>("static limits", corpus, messages, message_count);
+    bench_policy<UncheckedSizePolicy>("unchecked", corpus, messages, message_count);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "bench_utils.hpp"
+#include "stream_reader.hpp"
+#include "mapped_file.hpp"
+
+using namespace timl;
+
+namespace {
+
+    void decode_from_string(const std::string& name, const std::string& data, std::size_t buffer_size)
+    {
+        const std::size_t iterations = 200;
+        Value v;
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            std::istringstream ss(data);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name, ns, data.size());
+    }
+
+    void decode_from_file(const std::string& name, const std::string& path, std::size_t bytes, std::size_t buffer_size)
+    {
+        const std::size_t iterations = 200;
+        Value v;
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            std::ifstream file(path, std::ios::binary);
+            OstreamReader reader(file, defaultStreamReaderPolicy(), buffer_size);
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name, ns, bytes);
+    }
+
+    void decode_from_memory(const std::string& name, const std::string& data)
+    {
+        const std::size_t iterations = 200;
+        Value v;
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan span(reinterpret_cast<const byte*>(data.data()), data.size());
+            BufferReader reader(span);
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name, ns, data.size());
+    }
+
+    void decode_from_mapping(const std::string& name, const std::string& path, std::size_t bytes)
+    {
+        const std::size_t iterations = 200;
+        Value v;
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            MappedFileReader reader(path);
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name, ns, bytes);
+    }
+
+}
+
+void bench_buffered_reader()
+{
+    const std::string data = bench::encode(bench::tst_corpus(50 * 1024));
+    const std::string path = "tst_bench.ubex";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(data.data(), data.size());
+    }
+    std::cout << "  document: " << data.size() << " bytes of tst.ubex records\n";
+
+    decode_from_string("istringstream, unbuffered (per-primitive read)", data, 0);
+    decode_from_string("istringstream, 64KiB block buffer", data, defaultReadBufferSize());
+    decode_from_file("ifstream, unbuffered (per-primitive read)", path, data.size(), 0);
+    decode_from_file("ifstream, 64KiB block buffer", path, data.size(), defaultReadBufferSize());
+    decode_from_mapping("MappedFileReader", path, data.size());
+    decode_from_memory("BufferReader over the encoded bytes", data);
+    std::remove(path.c_str());
+}
+
+void bench_blob_reader()
+{
+    Value blobs;
+    for(int i = 0; i < 4; ++i)
+    {
+        Value blob;
+        blob["id"] = i;
+        blob["mime"] = std::string(64 * 1024, 'm');
+        blob["data"] = Value::BinaryType(4 * 1024 * 1024, static_cast<byte>(i));
+        blobs.push_back(std::move(blob));
+    }
+    Value document;
+    document["blobs"] = std::move(blobs);
+    const std::string data = bench::encode(document);
+    std::cout << "  document: " << data.size() << " bytes, 4 x 4MiB Binary + 4 x 64KiB String\n";
+
+    decode_from_string("istringstream, 64KiB block buffer", data, defaultReadBufferSize());
+    decode_from_memory("BufferReader over the encoded bytes", data);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#ifndef BENCH_UTILS_HPP
+#define BENCH_UTILS_HPP
+
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include "value.hpp"
+#include "stream_writer.hpp"
+
+namespace bench {
+
+    //! runs \a fn \a iterations times and returns the mean wall time of one iteration in nanoseconds
+    template<typename Function>
+    double time_per_iteration(std::size_t iterations, Function&& fn)
+    {
+        using namespace std::chrono;
+        fn();   //warm up
+        auto start = high_resolution_clock::now();
+        for(std::size_t i = 0; i < iterations; ++i)
+            fn();
+        auto elapsed = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+        return double(elapsed) / iterations;
+    }
+
+    inline void report(const std::string& name, double ns_per_iteration, std::size_t bytes_per_iteration)
+    {
+        const double mb_per_sec = (bytes_per_iteration / (1024.0 * 1024.0)) / (ns_per_iteration / 1e9);
+        std::cout << "  " << std::left << std::setw(48) << name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1) << ns_per_iteration / 1000.0 << " us/iter"
+                  << std::setw(10) << std::setprecision(1) << mb_per_sec << " MB/s\n";
+    }
+
+    //! The same document main.cpp's tst() writes to "tst.ubex"
+    inline timl::Value tst_document()
+    {
+        timl::Value v1;
+        v1["name"] = "Ibrahim";
+        v1["surname"] = "Onogu";
+        v1["country"] = "NG";
+        v1["faves"] = {453, -34, '@', true, -9.80665, "So damn funny"};
+        v1["arrays"] = {v1, v1, v1};
+        return v1;
+    }
+
+    inline std::string encode(const timl::Value& value,
+                              timl::StreamWriterOptions options = timl::defaultStreamWriterOptions())
+    {
+        std::ostringstream ss;
+        timl::StreamWriter<std::ostream> writer(ss, options);
+        writer.writeValue(value);
+        return ss.str();
+    }
+
+    //! A document holding as many tst_document() records as needed to encode to at least \a min_bytes
+    inline timl::Value tst_corpus(std::size_t min_bytes)
+    {
+        const timl::Value record = tst_document();
+        const std::size_t record_size = encode(record).size();
+        timl::Value records;
+        for(std::size_t sz = 0; sz < min_bytes; sz += record_size)
+            records.push_back(record);
+
+        timl::Value corpus;
+        corpus["records"] = std::move(records);
+        return corpus;
+    }
+
+}   //end namespace bench
+
+#endif // BENCH_UTILS_HPP
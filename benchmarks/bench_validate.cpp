@@ -0,0 +1,89 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+#include "bench_utils.hpp"
+#include "validate.hpp"
+
+using namespace timl;
+
+namespace {
+
+    void bench_validating(const std::string& name, const std::string& doc, std::size_t iterations)
+    {
+        const ByteSpan span(reinterpret_cast<const byte*>(doc.data()), doc.size());
+
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            if(not validate(span))
+                std::cerr << "validation failed" << std::endl;
+        });
+        bench::report(name + ", validate()", ns, doc.size());
+
+        ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes);
+            if(not reader.skipNextValue())
+                std::cerr << "skip failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name + ", skipNextValue()", ns, doc.size());
+
+        ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes);
+            Value v;
+            if(not reader.getNextValue(v))
+                std::cerr << "decode failed: " << reader.getLastError() << std::endl;
+        });
+        bench::report(name + ", getNextValue()", ns, doc.size());
+    }
+
+    //! small messages cut short, as off a flaky connection: the exception path against the error code one
+    void bench_rejecting(const std::string& doc, std::size_t iterations)
+    {
+        const std::string truncated = doc.substr(0, doc.size() / 2);
+        const ByteSpan span(reinterpret_cast<const byte*>(truncated.data()), truncated.size());
+
+        auto ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes);
+            Value v;
+            if(reader.getNextValue(v))
+                std::cerr << "a truncated message decoded" << std::endl;
+        });
+        bench::report("Truncated messages, getNextValue()", ns, truncated.size());
+
+        ns = bench::time_per_iteration(iterations, [&]{
+            ByteSpan bytes = span;
+            BufferReader reader(bytes);
+            Value v;
+            if(reader.tryGetNextValue(v))
+                std::cerr << "a truncated message decoded" << std::endl;
+        });
+        bench::report("Truncated messages, tryGetNextValue()", ns, truncated.size());
+    }
+
+}
+
+void bench_validate()
+{
+    bench_validating("4 MB of records", bench::encode(bench::tst_corpus(4*1024*1024)), 10);
+
+    //strings and numbers in bulk, whose payloads are stepped over
+    Value bulk;
+    for(int i = 0; i < 1000; ++i)
+        bulk["names"].push_back(std::string(2000, static_cast<char>('a' + i % 26)));
+    for(int i = 0; i < 500000; ++i)
+        bulk["samples"].push_back(i * 0.5);
+    bench_validating("6 MB of Strings and numbers", bench::encode(bulk), 10);
+
+    bench_rejecting(bench::encode(bench::tst_corpus(4*1024)), 2000);
+}
@@ -0,0 +1,291 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file async_fd.hpp
+  * Reading and writing documents over non-blocking file descriptors, driven by an epoll event loop
+  *
+  * @brief EventLoop, AsyncReader and AsyncWriter
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef ASYNC_FD_HPP
+#define ASYNC_FD_HPP
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "value.hpp"
+#include "push_parser.hpp"
+#include "stream_writer.hpp"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#define UBEX_HAS_COROUTINES 1
+#endif
+
+namespace timl {
+
+    /*!
+     * \brief The EventLoop class
+     * Runs callbacks once file descriptors become readable or writable, as epoll reports them.
+     * Every wait is one-shot: a callback runs once, and has to wait again for more.
+     * Failures of epoll itself are reported by throwing std::system_error
+     */
+    class EventLoop
+    {
+    public:
+        EventLoop();
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator = (const EventLoop&) = delete;
+
+        //! runs \a callback once \a fd is readable, or has hung up; at most one wait per direction and fd
+        void whenReadable(int fd, std::function<void()> callback);
+        void whenWritable(int fd, std::function<void()> callback);
+
+        //! runs \a callback from the loop, before it waits on any fd again
+        void post(std::function<void()> callback);
+
+        //! drops the waits on \a fd, without running them; do so before closing it
+        void forget(int fd);
+
+        //! the callbacks waiting, or posted
+        std::size_t pending() const noexcept { return waiting + posted.size(); }
+
+        /*!
+         * \brief runs the posted callbacks, then those of the fds ready within \a timeout_ms
+         * \return the callbacks run
+         */
+        std::size_t runOnce(int timeout_ms = -1);
+
+        //! runs callbacks until none are left waiting
+        void run();
+
+    private:
+        struct Waiters
+        {
+            std::function<void()> readable;
+            std::function<void()> writable;
+        };
+
+        void update(int fd, const Waiters& w, bool registered);
+
+        int epoll_fd;
+        std::unordered_map<int, Waiters> waiters;
+        std::size_t waiting = 0;
+        std::deque<std::function<void()>> posted;
+    };
+
+    //! How an asynchronous read, or write, went
+    enum class IoStatus
+    {
+        Ready,          //!< the document was read, or written out completely
+        WouldBlock,     //!< the fd has to become ready first; nothing is lost meanwhile
+        Closed,         //!< the peer closed the connection between documents
+        Error           //!< see getLastError()
+    };
+
+    /*!
+     * \brief The AsyncReader class
+     * Reads the documents a peer writes to a non-blocking \a fd, one at a time, without ever blocking.
+     * Bytes are decoded with a PushParser as they arrive, so a document read over several wake ups is
+     * never parsed over again. Documents are read in their order on the wire.
+     *
+     * \code
+     * void serve(AsyncReader& reader, Value& request)
+     * {
+     *      reader.next(request, [&](IoStatus s) {
+     *          if(s == IoStatus::Ready)
+     *          {
+     *              handle(request);
+     *              serve(reader, request);
+     *          }
+     *      });
+     * }
+     * \endcode
+     *
+     * Compiled as C++20, next() without a callback can be co_await'ed instead. The \a fd remains owned by the caller,
+     * who has to EventLoop::forget() it before the reader goes, if a read is still waiting.
+     */
+    class AsyncReader
+    {
+    public:
+        AsyncReader(EventLoop& loop, int fd, ValueSizePolicy policy = defaultStreamReaderPolicy(),
+                    std::size_t buffer_size = defaultReadBufferSize());
+
+        /*!
+         * \brief reads the next document into \a v if its bytes have arrived; never blocks
+         * \return WouldBlock if the document is incomplete so far
+         */
+        IoStatus tryNext(Value& v);
+
+        /*!
+         * \brief reads the next document into \a v, waiting for its bytes on the EventLoop
+         * \a done is always run from the loop, never from within next(); \a v has to outlive the wait
+         */
+        void next(Value& v, std::function<void(IoStatus)> done);
+
+#ifdef UBEX_HAS_COROUTINES
+        struct NextAwaiter;
+        NextAwaiter next(Value& v);
+#endif
+
+        //! what the last Error was; for malformed documents, getParseResult() tells where
+        std::string getLastError() const { return last_error; }
+        ParseResult getParseResult() const { return parser.error(); }
+
+        int fd() const noexcept { return file; }
+
+    private:
+        IoStatus fail(std::string error);
+        void wait(Value& v, std::function<void(IoStatus)> done);
+
+        EventLoop& loop;
+        const int file;
+        PushParser parser;
+        std::vector<byte> buffer;
+        std::size_t pos = 0;            //! the bytes of buffer not fed to the parser yet
+        std::size_t end = 0;
+        bool mid_document = false;      //! whether the parser holds part of a document
+        std::string last_error;
+    };
+
+    /*!
+     * \brief The AsyncWriter class
+     * Writes documents to a non-blocking \a fd. A document is encoded whole into an output queue upfront,
+     * and sent as far as the fd takes it; the rest goes out as the fd becomes writable again.
+     *
+     * Compiled as C++20, write() without a callback can be co_await'ed instead. The \a fd remains owned by the caller,
+     * as for AsyncReader
+     */
+    class AsyncWriter
+    {
+    public:
+        AsyncWriter(EventLoop& loop, int fd, StreamWriterOptions options = defaultStreamWriterOptions());
+
+        /*!
+         * \brief queues \a v and sends what the fd takes right away; never blocks
+         * \return WouldBlock if some of the queue is still to be sent, see flush(). Only Objects can be written
+         */
+        IoStatus tryWrite(const Value& v);
+
+        //! sends as much of the queue as the fd takes
+        IoStatus flush();
+
+        /*!
+         * \brief queues \a v, then runs \a done once the whole queue is sent
+         * \a done is always run from the loop, never from within write()
+         */
+        void write(const Value& v, std::function<void(IoStatus)> done);
+
+#ifdef UBEX_HAS_COROUTINES
+        struct WriteAwaiter;
+        WriteAwaiter write(const Value& v);
+#endif
+
+        //! the bytes queued, not sent yet
+        std::size_t queued() const noexcept { return out.size() - sent; }
+
+        std::string getLastError() const { return last_error; }
+
+        int fd() const noexcept { return file; }
+
+    private:
+        bool queue(const Value& v);
+        void wait(std::function<void(IoStatus)> done);
+
+        //! the sink StreamWriter appends the encoded documents to
+        struct Queue
+        {
+            std::string& bytes;
+            void write(const char* b, std::size_t sz) { bytes.append(b, sz); }
+        };
+
+        EventLoop& loop;
+        const int file;
+        const StreamWriterOptions options;
+        std::string out;
+        std::size_t sent = 0;
+        std::string last_error;
+    };
+
+
+#ifdef UBEX_HAS_COROUTINES
+
+    //! co_await reader.next(v) suspends until a document is read, or the read fails
+    struct AsyncReader::NextAwaiter
+    {
+        AsyncReader& reader;
+        Value& value;
+        IoStatus status = IoStatus::WouldBlock;
+
+        bool await_ready() { status = reader.tryNext(value); return status != IoStatus::WouldBlock; }
+        void await_suspend(std::coroutine_handle<> h)
+        { reader.wait(value, [this, h](IoStatus s) { status = s; h.resume(); }); }
+        IoStatus await_resume() const noexcept { return status; }
+    };
+
+    inline AsyncReader::NextAwaiter AsyncReader::next(Value& v)
+    { return NextAwaiter{*this, v}; }
+
+    //! co_await writer.write(v) suspends until the whole queue is sent, or sending fails
+    struct AsyncWriter::WriteAwaiter
+    {
+        AsyncWriter& writer;
+        IoStatus status;
+
+        bool await_ready() const noexcept { return status != IoStatus::WouldBlock; }
+        void await_suspend(std::coroutine_handle<> h)
+        { writer.wait([this, h](IoStatus s) { status = s; h.resume(); }); }
+        IoStatus await_resume() const noexcept { return status; }
+    };
+
+    inline AsyncWriter::WriteAwaiter AsyncWriter::write(const Value& v)
+    { return WriteAwaiter{*this, tryWrite(v)}; }
+
+    /*!
+     * \brief A coroutine that starts right away and cleans up after itself once it returns;
+     * its caller goes on at its first suspension. Exceptions escaping it terminate the program
+     *
+     * \code
+     * Detached echo(AsyncReader& in, AsyncWriter& out)
+     * {
+     *      Value v;
+     *      while(co_await in.next(v) == IoStatus::Ready)
+     *          if(co_await out.write(v) != IoStatus::Ready)
+     *              break;
+     * }
+     * \endcode
+     */
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+#endif // UBEX_HAS_COROUTINES
+
+}   //end namespace timl
+
+#endif // ASYNC_FD_HPP
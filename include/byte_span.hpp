@@ -0,0 +1,129 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file byte_span.hpp
+  * Non-owning views over contiguous sequences of bytes and characters
+  *
+  * @brief ByteSpan and StringRef
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef BYTE_SPAN_HPP
+#define BYTE_SPAN_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "types.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief The ByteSpan class
+     * A pointer and a length. It never owns the bytes it refers to,
+     * the client has to keep them alive for as long as the span is used.
+     *
+     * \code
+     * std::vector<byte> payload = receive();
+     * ByteSpan span(payload);
+     * BufferReader reader(span);
+     * Value v = reader.getNextValue();
+     * \endcode
+     */
+    class ByteSpan
+    {
+    public:
+        constexpr ByteSpan() noexcept
+            : first(nullptr), len(0) {}
+
+        constexpr ByteSpan(const byte* data, std::size_t size) noexcept
+            : first(data), len(size) {}
+
+        ByteSpan(const std::vector<byte>& bytes) noexcept
+            : first(bytes.data()), len(bytes.size()) {}
+
+        constexpr const byte* data() const noexcept { return first; }
+        constexpr std::size_t size() const noexcept { return len; }
+        constexpr bool empty() const noexcept { return len == 0; }
+
+        constexpr const byte* begin() const noexcept { return first; }
+        constexpr const byte* end() const noexcept { return first + len; }
+
+        constexpr byte operator [] (std::size_t i) const noexcept { return first[i]; }
+
+        //! returns the bytes in [offset, offset + count) clamped to this span
+        ByteSpan subspan(std::size_t offset, std::size_t count = std::size_t(-1)) const noexcept
+        {
+            if(offset > len)
+                offset = len;
+            if(count > len - offset)
+                count = len - offset;
+            return ByteSpan(first + offset, count);
+        }
+
+    private:
+        const byte* first;
+        std::size_t len;
+    };
+
+
+    /*!
+     * \brief The StringRef class
+     * A non-owning, read-only reference to characters owned by somebody else (a std::string_view for C++14).
+     * Use str() to take a copy that outlives the referenced characters
+     */
+    class StringRef
+    {
+    public:
+        constexpr StringRef() noexcept
+            : first(nullptr), len(0) {}
+
+        constexpr StringRef(const char* data, std::size_t size) noexcept
+            : first(data), len(size) {}
+
+        StringRef(const char* c) noexcept
+            : first(c), len(std::strlen(c)) {}
+
+        StringRef(const std::string& s) noexcept
+            : first(s.data()), len(s.size()) {}
+
+        constexpr const char* data() const noexcept { return first; }
+        constexpr std::size_t size() const noexcept { return len; }
+        constexpr bool empty() const noexcept { return len == 0; }
+
+        constexpr const char* begin() const noexcept { return first; }
+        constexpr const char* end() const noexcept { return first + len; }
+
+        constexpr char operator [] (std::size_t i) const noexcept { return first[i]; }
+
+        std::string str() const { return std::string(first, len); }
+
+        ByteSpan bytes() const noexcept { return ByteSpan(reinterpret_cast<const byte*>(first), len); }
+
+        friend bool operator == (StringRef lhs, StringRef rhs) noexcept
+        { return lhs.len == rhs.len and (lhs.len == 0 or std::memcmp(lhs.first, rhs.first, lhs.len) == 0); }
+
+        friend bool operator != (StringRef lhs, StringRef rhs) noexcept
+        { return not (lhs == rhs); }
+
+    private:
+        const char* first;
+        std::size_t len;
+    };
+
+}   //end namespace timl
+
+#endif // BYTE_SPAN_HPP
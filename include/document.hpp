@@ -0,0 +1,237 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file document.hpp
+  * A decoded document whose values all live in one arena, and are released at once
+  *
+  * @brief Document and ValueView
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef DOCUMENT_HPP
+#define DOCUMENT_HPP
+
+#include <memory>
+#include <vector>
+#include <string>
+#include "value.hpp"
+#include "byte_span.hpp"
+
+namespace timl {
+
+    class Document;
+    class DocumentBuilder;
+
+    /*!
+     * \brief The ValueView class
+     * A read-only value of a Document, offering the read API of \ref Value. The items of a container
+     * are laid out next to each other, so they are iterated over as a plain array; each item of a Map
+     * knows its own key(). Just like Value, an empty container is Null, and the last of the items given
+     * under the same key is the only one a Map keeps; it stays where it came in the document.
+     *
+     * \code
+     * for(const ValueView& item : doc.root())
+     *      std::cout << item.key().str() << ": " << item.asString() << '\n';
+     * \endcode
+     *
+     * A ValueView is owned by its Document, and is valid until the Document is cleared, refilled or destroyed
+     */
+    class ValueView
+    {
+    public:
+        Type type() const noexcept { return vtype; }
+
+        //! the number of items for Map and Array types, 0 for Null, otherwise 1; just like Value::size()
+        std::size_t size() const noexcept;
+
+        bool isMap() const noexcept { return vtype == Type::Map; }
+        bool isObject() const noexcept { return isMap(); }
+        bool isArray() const noexcept { return vtype == Type::Array; }
+        bool isNull() const noexcept { return vtype == Type::Null; }
+        bool isChar() const noexcept { return vtype == Type::Char; }
+        bool isBool() const noexcept { return vtype == Type::Bool; }
+        bool isFloat() const noexcept { return vtype == Type::Float; }
+        bool isString() const noexcept { return vtype == Type::String; }
+        bool isBinary() const noexcept { return vtype == Type::Binary; }
+        bool isSignedInteger() const noexcept { return vtype == Type::SignedInt; }
+        bool isUnsignedInteger() const noexcept { return vtype == Type::UnsignedInt; }
+        bool isInteger() const noexcept { return isSignedInteger() or isUnsignedInteger(); }
+        bool isNumeric() const noexcept { return isInteger() or isFloat(); }
+
+        //! The conversions of Value::asBool() and friends. Containers are copied into a Value whole for them
+        bool                asBool()   const { return toValue().asBool();   }
+        int                 asInt()    const { return toValue().asInt();    }
+        unsigned int        asUint()   const { return toValue().asUint();   }
+        long long           asInt64()  const { return toValue().asInt64();  }
+        unsigned long long  asUint64() const { return toValue().asUint64(); }
+        double              asFloat()  const { return toValue().asFloat();  }
+        std::string         asString() const { return toValue().asString(); }
+        Value::BinaryType   asBinary() const { return toValue().asBinary(); }
+
+        //! the characters of a String, or the bytes of a Binary, in place; empty for every other type
+        StringRef str() const noexcept;
+        ByteSpan bytes() const noexcept;
+
+        //! the key this value is stored under, if it is an item of a Map
+        StringRef key() const noexcept { return item_key; }
+
+        /*!
+         * \brief returns the \a i'th item of an Array
+         * \throws value_exception if this isn't an Array, std::out_of_range if there is no such item
+         */
+        const ValueView& operator [] (int i) const;
+
+        /*!
+         * \brief returns the item stored under \a key in a Map. Like Value, the last of duplicated keys wins
+         * \throws value_exception if this isn't a Map, std::out_of_range if there is no such key
+         */
+        const ValueView& operator [] (const std::string& key) const;
+        const ValueView& operator [] (const char* key) const;
+
+        //! whether this is a Map with an item stored under \a key
+        bool contains(StringRef key) const noexcept;
+
+        //! the keys of a Map in document order; empty for every other type. As for Value, a key given twice counts once
+        Value::Keys keys() const;
+
+        //! the items of a Map or Array in document order; nothing for every other type
+        const ValueView* begin() const noexcept { return isMap() or isArray() ? items : nullptr; }
+        const ValueView* end() const noexcept { return isMap() or isArray() ? items + count : nullptr; }
+
+        //! copies this whole subtree into a Value
+        Value toValue() const;
+
+    private:
+        friend class DocumentBuilder;
+
+        const ValueView* find(StringRef key) const noexcept;
+
+        Type vtype = Type::Null;
+        union
+        {
+            unsigned long long UnsignedInt = 0;
+            bool Bool;
+            char Char;
+            long long SignedInt;
+            double Float;
+            const char* chars;          //! of a String or Binary
+            const ValueView* items;     //! of a Map or Array
+        };
+        std::size_t count = 0;          //! characters, bytes or items
+        StringRef item_key;
+    };
+
+    /*!
+     * \brief The Document class
+     * Holds a decoded document in a monotonic arena: its values, strings and containers are carved out
+     * of a few large blocks, and nothing is freed one by one. Destroying or refilling a Document thus
+     * costs a handful of deallocations, however many values the document holds. Decode into it with
+     * StreamReader::getNextValue(Document&)
+     *
+     * \code
+     * Document doc;
+     * while(reader.getNextValue(doc))          //the arena of the last document is reused
+     *      handle(doc.root()["user"]["id"].asInt64());
+     * \endcode
+     *
+     * The arena keeps the room the largest document so far needed, so refilling a Document with documents
+     * of similar sizes allocates nothing at all. A Document is not safe to share between threads while refilled.
+     */
+    class Document
+    {
+    public:
+        //! \param block_size the size of the first block of the arena; more are added as needed
+        explicit Document(std::size_t block_size = 64*1024);
+
+        Document(const Document&) = delete;
+        Document& operator = (const Document&) = delete;
+        //! the moved from Document is left empty, and may be refilled; its arena is then allocated anew
+        Document(Document&& other) noexcept;
+        Document& operator = (Document&& other) noexcept;
+
+        const ValueView& root() const noexcept { return top; }
+
+        //! releases every value at once, keeping the arena for the next document
+        void clear() noexcept;
+
+        //! the bytes of the arena the document takes up, and those the arena holds
+        std::size_t bytesUsed() const noexcept;
+        std::size_t bytesReserved() const noexcept;
+
+    private:
+        friend class DocumentBuilder;
+
+        struct Block
+        {
+            std::unique_ptr<byte[]> bytes;
+            std::size_t size;
+        };
+
+        //! \return room for \a size bytes, aligned for any ValueView or character
+        void* allocate(std::size_t size);
+
+        std::vector<Block> blocks;      //! none once moved from
+        std::size_t first_block;        //! the size of the first block, for an arena allocated anew
+        std::size_t used = 0;           //! of the last block
+        std::size_t retired = 0;        //! the bytes used of every block but the last
+        ValueView top;
+
+        //! DocumentBuilder's, kept here so that their room is reused across documents too
+        std::vector<ValueView> pending;     //! the items of the open containers, each container ahead of its items
+        std::vector<std::size_t> open_at;   //! where in pending each open container is
+        std::vector<std::size_t> order;     //! scratch for dropShadowed(), as the Maps are closed
+    };
+
+    /*!
+     * \brief The DocumentBuilder class
+     * The Handler behind StreamReader::getNextValue(Document&); it copies the events into the Document's arena.
+     * The items of a container are gathered aside until its end, then copied next to each other
+     */
+    class DocumentBuilder
+    {
+    public:
+        //! \post the Document is cleared; it is replaced by the first top level value
+        explicit DocumentBuilder(Document& document);
+
+        void null()                         { put(ValueView()); }
+        void boolean(bool b)                { ValueView v; v.vtype = Type::Bool; v.Bool = b; put(v); }
+        void character(char c)              { ValueView v; v.vtype = Type::Char; v.Char = c; put(v); }
+        void int64(long long ll)            { ValueView v; v.vtype = Type::SignedInt; v.SignedInt = ll; put(v); }
+        void uint64(unsigned long long ull) { ValueView v; v.vtype = Type::UnsignedInt; v.UnsignedInt = ull; put(v); }
+        void float64(double d)              { ValueView v; v.vtype = Type::Float; v.Float = d; put(v); }
+        void string(StringRef s)            { sequence(Type::String, s.data(), s.size()); }
+        void binary(ByteSpan b)             { sequence(Type::Binary, reinterpret_cast<const char*>(b.data()), b.size()); }
+
+        void key(StringRef k)               { pending_key = StringRef(copy(k.data(), k.size()), k.size()); }
+
+        void startObject(std::size_t)       { open(Type::Map); }
+        void endObject()                    { close(); }
+        void startArray(std::size_t)        { open(Type::Array); }
+        void endArray()                     { close(); }
+
+    private:
+        void put(ValueView v);
+        void sequence(Type type, const char* data, std::size_t size);
+        const char* copy(const char* data, std::size_t size);
+        void open(Type type);
+        void close();
+
+        Document& doc;
+        StringRef pending_key;
+    };
+
+}   //end namespace timl
+
+#endif // DOCUMENT_HPP
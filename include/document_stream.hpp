@@ -0,0 +1,181 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file document_stream.hpp
+  * Iterates over the concatenated documents of a StreamReader
+  *
+  * @brief DocumentStream
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef DOCUMENT_STREAM_HPP
+#define DOCUMENT_STREAM_HPP
+
+#include <chrono>
+#include <iterator>
+#include "value.hpp"
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    //! What a DocumentStream has gone through so far
+    struct DocumentStreamStats
+    {
+        std::size_t documents;  //!< documents decoded
+        std::size_t bytes;      //!< bytes read, the failed document's included
+        double seconds;         //!< wall time from the first document's start to the last one's end
+
+        double documentsPerSecond() const noexcept { return seconds > 0 ? documents / seconds : 0; }
+        double bytesPerSecond() const noexcept { return seconds > 0 ? bytes / seconds : 0; }
+    };
+
+    /*!
+     * \brief The DocumentStream class
+     * A single pass range over the Objects written back to back into a StreamReader's source,
+     * e.g a log file of records. Each one is decoded into the same Value, in turn, by the reader's
+     * getNextValue(); so its setRecycling() and setKeyTable() apply just the same.
+     *
+     * \code
+     * std::ifstream log("records.ubex", std::ios::binary);
+     * StreamReader<std::ifstream> reader(log);
+     * DocumentStream<std::ifstream> records(reader);
+     * for(Value& record : records)
+     *      process(record);
+     * if(records.failed())
+     *      std::cerr << records.getLastError() << '\n';
+     * std::cerr << records.stats().documentsPerSecond() << " records/s\n";
+     * \endcode
+     *
+     * The reader's ValueSizePolicy applies to each document on its own, while stats() adds them up.
+     * Iteration ends cleanly at the end of the source, or at the first malformed document; failed()
+     * tells which one it was. The reader's buffer is reused across documents; with recycling on, so are the
+     * containers of value().
+     * \a SizePolicy is that of the reader.
+     */
+    template<typename StreamType, typename SizePolicy = ValueSizePolicy>
+    class DocumentStream
+    {
+    public:
+        class iterator;
+
+        explicit DocumentStream(StreamReader<StreamType, SizePolicy>& Reader)
+            : reader(Reader) {}
+
+        DocumentStream(const DocumentStream&) = delete;
+        DocumentStream& operator = (const DocumentStream&) = delete;
+
+        /*!
+         * \brief decodes the next document into value()
+         * \return false at the end of the source, or if the document is malformed; see failed()
+         */
+        bool next();
+
+        //! the last document next() decoded
+        Value& value() noexcept { return current; }
+
+        //! whether iteration stopped at a malformed document rather than the end of the source
+        bool failed() const noexcept { return state == State::Failed; }
+
+        std::string getLastError() const { return reader.getLastError(); }
+
+        DocumentStreamStats stats() const noexcept { return totals; }
+
+        //! decodes the first document, unless next() was already called
+        iterator begin();
+        iterator end() { return iterator(nullptr); }
+
+    private:
+        enum class State { Fresh, Reading, Ended, Failed };
+
+        StreamReader<StreamType, SizePolicy>& reader;
+        Value current;
+        State state = State::Fresh;
+        DocumentStreamStats totals{0, 0, 0};
+        std::chrono::steady_clock::time_point started;
+    };
+
+    /*!
+     * \brief The DocumentStream::iterator class
+     * An input iterator over the decoded documents; every one of them dereferences to the same Value
+     */
+    template<typename StreamType, typename SizePolicy>
+    class DocumentStream<StreamType, SizePolicy>::iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        explicit iterator(DocumentStream* Parent)
+            : parent(Parent) {}
+
+        reference operator * () const { return parent->value(); }
+        pointer operator -> () const { return &parent->value(); }
+
+        iterator& operator ++ ()
+        {
+            if(not parent->next())
+                parent = nullptr;
+            return *this;
+        }
+
+        bool operator == (const iterator& rhs) const { return parent == rhs.parent; }
+        bool operator != (const iterator& rhs) const { return not (*this == rhs); }
+
+    private:
+        DocumentStream* parent;
+    };
+
+
+    template<typename StreamType, typename SizePolicy>
+    bool DocumentStream<StreamType, SizePolicy>::next()
+    {
+        if(state == State::Ended or state == State::Failed)
+            return false;
+        if(state == State::Fresh)
+        {
+            started = std::chrono::steady_clock::now();
+            state = State::Reading;
+        }
+
+        bool good = false;
+        if(reader.atEnd())
+            state = State::Ended;
+        else
+        {
+            good = reader.getNextValue(current);
+            if(good)
+                ++totals.documents;
+            else
+                state = State::Failed;
+            totals.bytes += reader.getBytesRead();
+        }
+        totals.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return good;
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    typename DocumentStream<StreamType, SizePolicy>::iterator DocumentStream<StreamType, SizePolicy>::begin()
+    {
+        if(state == State::Fresh and not next())
+            return end();
+        return iterator(state == State::Reading ? this : nullptr);
+    }
+
+}   //end namespace timl
+
+#endif // DOCUMENT_STREAM_HPP
@@ -0,0 +1,97 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file endian_kernels.hpp
+  * Bulk conversions between native and big endian numbers, with the kernel picked for the running CPU
+  *
+  * @brief EndianKernels
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef ENDIAN_KERNELS_HPP
+#define ENDIAN_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "types.hpp"
+
+namespace timl {
+
+    //! The instruction sets there are byteswap kernels for
+    enum class EndianIsa
+    {
+        Scalar,     //!< a plain loop; the only kernels on CPUs other than x86-64
+        SSE2,
+        SSSE3,
+        AVX2,
+        AVX512      //!< AVX-512 BW
+    };
+
+    /*!
+     * \brief The EndianKernels struct
+     * Each kernel converts \a n items of 2, 4 or 8 bytes from \a src into \a dst, between the native
+     * byte order and big endian; the conversion is the same both ways. \a src and \a dst may be the same
+     * buffer, but must not otherwise overlap. Neither needs to be aligned.
+     */
+    struct EndianKernels
+    {
+        EndianIsa isa;
+        const char* name;
+        void (*swap16)(const byte* src, std::size_t n, byte* dst);
+        void (*swap32)(const byte* src, std::size_t n, byte* dst);
+        void (*swap64)(const byte* src, std::size_t n, byte* dst);
+    };
+
+    //! the fastest kernels the running CPU supports, looked up with cpuid on the first call
+    const EndianKernels& endianKernels() noexcept;
+
+    //! the kernels for \a isa, or nullptr if the running CPU, or the build, can't run them
+    const EndianKernels* endianKernels(EndianIsa isa) noexcept;
+
+
+    inline void toBigEndian16(const uint16_t* src, std::size_t n, byte* dst)
+    { endianKernels().swap16(reinterpret_cast<const byte*>(src), n, dst); }
+
+    inline void toBigEndian32(const uint32_t* src, std::size_t n, byte* dst)
+    { endianKernels().swap32(reinterpret_cast<const byte*>(src), n, dst); }
+
+    inline void toBigEndian64(const uint64_t* src, std::size_t n, byte* dst)
+    { endianKernels().swap64(reinterpret_cast<const byte*>(src), n, dst); }
+
+    inline void toBigEndianFloat32(const float* src, std::size_t n, byte* dst)
+    { endianKernels().swap32(reinterpret_cast<const byte*>(src), n, dst); }
+
+    inline void toBigEndianFloat64(const double* src, std::size_t n, byte* dst)
+    { endianKernels().swap64(reinterpret_cast<const byte*>(src), n, dst); }
+
+
+    inline void fromBigEndian16(const byte* src, std::size_t n, uint16_t* dst)
+    { endianKernels().swap16(src, n, reinterpret_cast<byte*>(dst)); }
+
+    inline void fromBigEndian32(const byte* src, std::size_t n, uint32_t* dst)
+    { endianKernels().swap32(src, n, reinterpret_cast<byte*>(dst)); }
+
+    inline void fromBigEndian64(const byte* src, std::size_t n, uint64_t* dst)
+    { endianKernels().swap64(src, n, reinterpret_cast<byte*>(dst)); }
+
+    inline void fromBigEndianFloat32(const byte* src, std::size_t n, float* dst)
+    { endianKernels().swap32(src, n, reinterpret_cast<byte*>(dst)); }
+
+    inline void fromBigEndianFloat64(const byte* src, std::size_t n, double* dst)
+    { endianKernels().swap64(src, n, reinterpret_cast<byte*>(dst)); }
+
+}   //end namespace timl
+
+#endif // ENDIAN_KERNELS_HPP
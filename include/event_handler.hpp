@@ -0,0 +1,287 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file event_handler.hpp
+  * The event Handler concept consumed by StreamReader::parse(), and the handlers shipped with the library
+  *
+  * @brief event handlers
+  * @author WhiZTiM
+  *
+  * A Handler is any type providing the following member functions.
+  * StreamReader::parse() calls them in document order:
+  *
+  * @code
+  * void null();
+  * void boolean(bool);
+  * void character(char);
+  * void int64(long long);              //Int8, Int16, Int32 and Int64 markers
+  * void uint64(unsigned long long);    //Uint8, Uint16, Uint32 and Uint64 markers
+  * void float64(double);               //Float32 and Float64 markers
+  * void string(StringRef);
+  * void binary(ByteSpan);
+  * void startObject(std::size_t count);
+  * void key(StringRef);                //precedes every value inside an Object
+  * void endObject();
+  * void startArray(std::size_t count); //both Homogenous and Hetrogenous arrays
+  * void endArray();
+  * @endcode
+  *
+  * The StringRef and ByteSpan arguments are never copied by the parser. For BufferReader, they point
+  * into the source bytes; for stream sources, they are only valid until the callback returns.
+  * A handler may throw parsing_exception to abort; parse() then reports it through getLastError()
+  *
+  * A handler that keeps every string and binary anyway can specialize handler_traits to receive
+  * them as \e std::string&& and \e Value::BinaryType&& instead; this saves a copy on stream sources.
+  *
+  * Likewise, a handler whose handler_traits set \e bulk_numbers receives the items of homogenous
+  * Arrays of integers or floats all at once, between their startArray() and endArray():
+  * @code
+  * void numbers(const NumericArray&);
+  * @endcode
+  *
+  */
+
+#ifndef EVENT_HANDLER_HPP
+#define EVENT_HANDLER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include "value.hpp"
+#include "byte_span.hpp"
+#include "key_table.hpp"
+#include "numeric_array.hpp"
+
+namespace timl {
+
+    //! Compile time properties of a Handler
+    template<typename Handler>
+    struct handler_traits
+    {
+        //! whether string() and binary() should receive owning copies rather than views
+        static constexpr bool owns_sequences = false;
+
+        //! whether homogenous numeric Arrays should be handed to numbers() whole, rather than item by item
+        static constexpr bool bulk_numbers = false;
+    };
+
+
+    /*!
+     * \brief The BasicHandler struct
+     * Ignores every event. Derive from it and hide only the callbacks you care about
+     *
+     * \code
+     * struct CountFaves : BasicHandler
+     * {
+     *      std::size_t faves = 0;
+     *      bool in_faves = false;
+     *      void key(StringRef k) { in_faves = (k == "faves"); }
+     *      void startArray(std::size_t count) { if(in_faves) faves = count; }
+     * };
+     * \endcode
+     */
+    struct BasicHandler
+    {
+        void null() {}
+        void boolean(bool) {}
+        void character(char) {}
+        void int64(long long) {}
+        void uint64(unsigned long long) {}
+        void float64(double) {}
+        void string(StringRef) {}
+        void binary(ByteSpan) {}
+        void startObject(std::size_t) {}
+        void key(StringRef) {}
+        void endObject() {}
+        void startArray(std::size_t) {}
+        void endArray() {}
+    };
+
+
+    /*!
+     * \brief The ValueBuilder class
+     * The Handler behind StreamReader::getNextValue(); it assembles the events into a \ref Value tree.
+     * Containers are built in place, children are never moved into their parents
+     * \post the \a root given at construction is replaced by the first top level value
+     */
+    class ValueBuilder
+    {
+    public:
+        //! Builds without reserving room for the items of containers
+        explicit ValueBuilder(Value& root)
+            : root(root), max_array_reserve(0), max_object_reserve(0) {}
+
+        /*!
+         * Reserves room for the items announced by each container's count. Counts come from the
+         * document, so reservations are capped at the \a policy's max_array_items and max_object_items.
+         * Keys are interned into \a keys, if given
+         */
+        ValueBuilder(Value& root, const ValueSizePolicy& policy, KeyTable* keys = nullptr)
+            : root(root), max_array_reserve(policy.max_array_items), max_object_reserve(policy.max_object_items),
+              key_table(keys) {}
+
+        void null()                         { put(Value()); }
+        void boolean(bool b)                { put(Value(b)); }
+        void character(char c)              { put(Value(c)); }
+        void int64(long long ll)            { put(Value(ll)); }
+        void uint64(unsigned long long ull) { put(Value(ull)); }
+        void float64(double d)              { put(Value(d)); }
+        void string(StringRef s)            { put(Value(s.str())); }
+        void binary(ByteSpan b)             { put(Value(Value::BinaryType(b.begin(), b.end()))); }
+        void string(std::string&& s)        { put(Value(std::move(s))); }
+        void binary(Value::BinaryType&& b)  { put(Value(std::move(b))); }
+
+        void numbers(const NumericArray& items)
+        {
+            switch (items.type()) {
+            case Type::SignedInt:   return putAll<long long>(items);
+            case Type::UnsignedInt: return putAll<unsigned long long>(items);
+            default:                return putAll<double>(items);
+            }
+        }
+
+        void key(StringRef k)               { pending_key = key_table ? key_table->intern(k) : Key(k.str()); }
+
+        void startObject(std::size_t count) { open(true, std::min(count, max_object_reserve)); }
+        void endObject()                    { stack.pop_back(); }
+        void startArray(std::size_t count)  { open(false, std::min(count, max_array_reserve)); }
+        void endArray()                     { stack.pop_back(); }
+
+        //! forgets a value left unfinished, so that the next event starts over at the root
+        void reset()                        { stack.clear(); pending_key = Key(); }
+
+    private:
+        struct Frame
+        {
+            Value* value;
+            std::size_t reserve;    //! room to make once the container holds its first item
+            bool is_object;
+        };
+
+        //! moves \a v into the container being built, or into the root
+        Value& put(Value&& v)
+        {
+            if(stack.empty())
+                return root = std::move(v);
+
+            Frame& top = stack.back();
+            Value& item = top.is_object ? top.value->emplace(std::move(pending_key), std::move(v))
+                                        : top.value->emplace_back(std::move(v));
+            //Until its first item, the container is still Null and has no storage to reserve
+            if(top.reserve > 1)
+                top.value->reserve(top.reserve);
+            top.reserve = 0;
+            return item;
+        }
+
+        //! decodes the items in one pass, then stores them without dispatching on any marker
+        template<typename T>
+        void putAll(const NumericArray& items)
+        {
+            for(T item : items.toVector<T>())
+                put(Value(item));
+        }
+
+        //! an empty container stays Null, just like an empty Value
+        void open(bool is_object, std::size_t reserve)
+        {
+            Value& v = put(Value());
+            stack.push_back(Frame{&v, reserve, is_object});
+        }
+
+        Value& root;
+        const std::size_t max_array_reserve;
+        const std::size_t max_object_reserve;
+        KeyTable* const key_table = nullptr;
+        Key pending_key;
+        std::vector<Frame> stack;
+    };
+
+    template<>
+    struct handler_traits<ValueBuilder>
+    {
+        static constexpr bool owns_sequences = true;
+        static constexpr bool bulk_numbers = true;
+    };
+
+
+    /*!
+     * \brief The ValueRecycler class
+     * The Handler behind StreamReader::getNextValue() once StreamReader::setRecycling() is on. Rather than
+     * replacing its target, it decodes into the containers the target already holds: Array items are refilled
+     * in place, Map items are looked up and refilled under their key, and strings and binaries are assigned
+     * into the storage they already have. Only what the new document lacks is then dropped. Its scratch
+     * state is kept across documents, so decoding documents shaped like the previous one allocates nothing.
+     *
+     * \post the target is equal to what ValueBuilder would have built from the same events
+     */
+    class ValueRecycler
+    {
+    public:
+        //! Containers it creates reserve room as ValueBuilder's do, capped by \a policy. New keys are interned into \a keys, if given
+        explicit ValueRecycler(const ValueSizePolicy& policy, KeyTable* keys = nullptr)
+            : max_array_reserve(policy.max_array_items), max_object_reserve(policy.max_object_items),
+              key_table(keys) {}
+
+        //! the next document is decoded into \a target, reusing whatever it holds
+        void refill(Value& target)          { root = &target; reset(); }
+
+        void setKeyTable(KeyTable* keys)    { key_table = keys; }
+
+        void null()                         { slot() = Value(); }
+        void boolean(bool b)                { slot() = Value(b); }
+        void character(char c)              { slot() = Value(c); }
+        void int64(long long ll)            { slot() = Value(ll); }
+        void uint64(unsigned long long ull) { slot() = Value(ull); }
+        void float64(double d)              { slot() = Value(d); }
+        void string(StringRef s);
+        void binary(ByteSpan b);
+
+        void key(StringRef k)               { pending_key.assign(k.data(), k.size()); }
+
+        void startObject(std::size_t count) { open(Type::Map, std::min(count, max_object_reserve)); }
+        void endObject()                    { close(); }
+        void startArray(std::size_t count)  { open(Type::Array, std::min(count, max_array_reserve)); }
+        void endArray()                     { close(); }
+
+        //! forgets a value left unfinished, so that the next event starts over at the target
+        void reset()                        { stack.clear(); stored.clear(); }
+
+    private:
+        struct Frame
+        {
+            Value* value;
+            Type type;
+            std::size_t filled;         //! the Array items refilled so far
+            std::size_t stored_from;    //! where in stored the Map's items start
+            std::size_t reserve;        //! room to make once the container holds its first item
+        };
+
+        //! the Value the next event is decoded into: the target, or the next item of the innermost container
+        Value& slot();
+        void open(Type type, std::size_t reserve);
+        void close();
+
+        Value* root = nullptr;
+        const std::size_t max_array_reserve;
+        const std::size_t max_object_reserve;
+        KeyTable* key_table = nullptr;
+        std::string pending_key;
+        std::vector<Frame> stack;
+        std::vector<const Value*> stored;   //! the items refilled in each open Map, to drop the others once it ends
+    };
+
+}   //end namespace timl
+
+#endif // EVENT_HANDLER_HPP
@@ -15,6 +15,7 @@
 #define EXCEPTION_H
 #include <exception>
 #include <stdexcept>
+#include "parse_result.hpp"
 
 namespace timl
 {
@@ -35,8 +36,16 @@ namespace timl
     class parsing_exception : public value_exception
     {
     public:
-        parsing_exception(const char* msg)
-            : value_exception(msg) {}
+        parsing_exception(const char* msg, ParseError code = ParseError::Malformed)
+            : value_exception(msg), error(code) {}
+
+        explicit parsing_exception(ParseError code)
+            : value_exception(describeError(code)), error(code) {}
+
+        ParseError code() const noexcept { return error; }
+
+    private:
+        ParseError error;
     };
 
 }
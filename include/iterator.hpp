@@ -14,6 +14,7 @@
 #ifndef ITERATOR_HPP
 #define ITERATOR_HPP
 
+#include <cstddef>
 #include <iterator>
 #include "types.hpp"
 
@@ -24,10 +25,14 @@ namespace timl
 template<typename Value_Type,
          typename Array_IteratorType,
          typename Map_IteratorType>
-class value_iterator :
-        public std::iterator<std::forward_iterator_tag, Value_Type>
+class value_iterator
 {
 public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value_Type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value_Type*;
+    using reference = Value_Type&;
 
     enum class pos { begin, end };
     value_iterator(Value_Type* Parent, pos p)
@@ -0,0 +1,184 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file key_table.hpp
+  * The keys of Value Maps, and a table interning them so that documents repeating the same keys share them
+  *
+  * @brief Key and KeyTable
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef KEY_TABLE_HPP
+#define KEY_TABLE_HPP
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include "byte_span.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief The Key class
+     * The key of a Value Map. It either owns its characters, just as a std::string does, or shares the
+     * immutable ones of an atom interned by a KeyTable. Copying an interned Key allocates nothing, and
+     * its hash was computed once, when it was interned. Atoms are reference counted, so Keys may outlive
+     * their KeyTable, and travel across threads
+     */
+    class Key
+    {
+    public:
+        Key() = default;
+        Key(std::string s) : owned(std::move(s)) {}
+        Key(const char* s) : owned(s) {}
+
+        Key(const Key& k) : atom(k.atom), borrowed(k.borrowed), owned(k.owned)
+        { retain(); }
+
+        Key(Key&& k) noexcept : atom(k.atom), borrowed(k.borrowed), owned(std::move(k.owned))
+        { k.atom = nullptr; }
+
+        Key& operator = (Key k) noexcept
+        {
+            std::swap(atom, k.atom);
+            std::swap(borrowed, k.borrowed);
+            owned.swap(k.owned);
+            return *this;
+        }
+
+        ~Key() { release(); }
+
+        //! a Key referring to \a s, to look a Map up without copying \a s; it must not outlive \a s
+        static Key borrow(const std::string& s) noexcept
+        {
+            Key k;
+            k.borrowed = &s;
+            return k;
+        }
+
+        const std::string& str() const noexcept
+        { return atom ? atom->text : borrowed ? *borrowed : owned; }
+
+        operator const std::string& () const noexcept { return str(); }
+
+        std::size_t hash() const noexcept
+        {
+            return atom ? atom->hash : std::hash<std::string>()(str());
+        }
+
+        //! whether it shares the characters of a KeyTable's atom
+        bool isInterned() const noexcept { return atom != nullptr; }
+
+        friend bool operator == (const Key& lhs, const Key& rhs) noexcept
+        { return (lhs.atom and lhs.atom == rhs.atom) or lhs.str() == rhs.str(); }
+
+        friend bool operator != (const Key& lhs, const Key& rhs) noexcept
+        { return not (lhs == rhs); }
+
+    private:
+        friend class KeyTable;
+
+        struct Atom
+        {
+            std::atomic<std::size_t> refs;
+            const std::size_t hash;
+            const std::string text;
+        };
+
+        //! shares \a a, which already counts this Key
+        explicit Key(Atom* a) noexcept : atom(a) {}
+
+        void retain() noexcept
+        {
+            if(atom)
+                atom->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() noexcept
+        {
+            if(atom and atom->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete atom;
+        }
+
+        Atom* atom = nullptr;
+        const std::string* borrowed = nullptr;
+        std::string owned;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator () (const Key& k) const noexcept { return k.hash(); }
+    };
+
+    /*!
+     * \brief The KeyTable class
+     * Interns the keys a reader decodes, so that a key repeated across documents is allocated once and shared
+     * by every Map holding it, see StreamReader::setKeyTable(). A table may serve several readers at once when
+     * constructed \a thread_safe; otherwise it must be used by one thread at a time.
+     *
+     * Documents from untrusted peers could make up keys without end, so at most \a max_keys are interned;
+     * keys past those are handed out as plain owned Keys
+     *
+     * \code
+     * KeyTable keys;
+     * StreamReader<std::ifstream> reader(log);
+     * reader.setKeyTable(&keys);
+     * \endcode
+     */
+    class KeyTable
+    {
+    public:
+        explicit KeyTable(bool thread_safe = false, std::size_t max_keys = 4096);
+        ~KeyTable();
+
+        KeyTable(const KeyTable&) = delete;
+        KeyTable& operator = (const KeyTable&) = delete;
+
+        //! \return the interned Key for \a k, interning it first if it is new and there is room
+        Key intern(StringRef k);
+
+        //! the keys interned so far
+        std::size_t size() const;
+
+    private:
+        //! the characters of a key, along with their hash, so that it is computed once per lookup
+        struct Probe
+        {
+            StringRef text;
+            std::size_t hash;
+
+            friend bool operator == (const Probe& lhs, const Probe& rhs) noexcept
+            { return lhs.text == rhs.text; }
+        };
+
+        struct ProbeHash
+        {
+            std::size_t operator () (const Probe& p) const noexcept { return p.hash; }
+        };
+
+        Key find_or_add(StringRef k);
+
+        const bool thread_safe;
+        const std::size_t max_keys;
+        mutable std::mutex mutex;
+        std::unordered_map<Probe, Key::Atom*, ProbeHash> atoms;   //! keyed by the atoms' own characters
+        std::string scratch;    //! hashes are those of std::string, which only hashes std::strings
+    };
+
+}   //end namespace timl
+
+#endif // KEY_TABLE_HPP
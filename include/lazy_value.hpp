@@ -0,0 +1,197 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file lazy_value.hpp
+  * A read-only view of an encoded UBEX document that only decodes what is accessed
+  *
+  * @brief LazyValue
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef LAZY_VALUE_HPP
+#define LAZY_VALUE_HPP
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <iterator>
+#include "value.hpp"
+#include "byte_span.hpp"
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief The LazyValue class
+     * Offers the read API of \ref Value over the encoded bytes of a document, e.g a received buffer or
+     * a MappedFile. A container is only scanned shallowly: the byte ranges of its items are recorded
+     * and skipped over. An item is decoded on its first access through operator[] or iteration;
+     * every other item is never decoded at all.
+     *
+     * \code
+     * MappedFile file("request.ubex");
+     * LazyValue doc(file.bytes());
+     * if(doc["user"]["id"].asInt64() == 42)
+     *      forward(doc["payload"].bytes());    // still encoded, nothing below "payload" was decoded
+     * \endcode
+     *
+     * The bytes must outlive the LazyValue and everything obtained from it. Malformed parts of
+     * the document are reported by throwing parsing_exception when they are first scanned.
+     * Objects carrying a Width hint are skipped in one step, so their items are only checked once accessed.
+     * Just like Value, an empty container is Null, and a Map keeps only the last of the items given under
+     * the same key, where it came in the document. A LazyValue is not safe to share between threads.
+     */
+    class LazyValue
+    {
+    public:
+        class const_iterator;
+
+        /*!
+         * \brief scans the Object at the start of \a document
+         * \throws parsing_exception if it doesn't start with a well formed Object
+         */
+        explicit LazyValue(ByteSpan document, ValueSizePolicy policy = defaultStreamReaderPolicy());
+
+        LazyValue(const LazyValue&) = delete;
+        LazyValue& operator = (const LazyValue&) = delete;
+        LazyValue(LazyValue&&) = default;
+        LazyValue& operator = (LazyValue&&) = default;
+        ~LazyValue();
+
+        Type type() const noexcept { return vtype; }
+
+        //! the number of items for Map and Array types, 0 for Null, otherwise 1; just like Value::size()
+        std::size_t size() const noexcept;
+
+        bool isMap() const noexcept { return vtype == Type::Map; }
+        bool isObject() const noexcept { return isMap(); }
+        bool isArray() const noexcept { return vtype == Type::Array; }
+        bool isNull() const noexcept { return vtype == Type::Null; }
+        bool isChar() const noexcept { return vtype == Type::Char; }
+        bool isBool() const noexcept { return vtype == Type::Bool; }
+        bool isFloat() const noexcept { return vtype == Type::Float; }
+        bool isString() const noexcept { return vtype == Type::String; }
+        bool isBinary() const noexcept { return vtype == Type::Binary; }
+        bool isSignedInteger() const noexcept { return vtype == Type::SignedInt; }
+        bool isUnsignedInteger() const noexcept { return vtype == Type::UnsignedInt; }
+        bool isInteger() const noexcept { return isSignedInteger() or isUnsignedInteger(); }
+        bool isNumeric() const noexcept { return isInteger() or isFloat(); }
+
+        //! The conversions of Value::asBool() and friends. Containers are decoded whole for them
+        bool                asBool()   const { return value().asBool();   }
+        int                 asInt()    const { return value().asInt();    }
+        unsigned int        asUint()   const { return value().asUint();   }
+        long long           asInt64()  const { return value().asInt64();  }
+        unsigned long long  asUint64() const { return value().asUint64(); }
+        double              asFloat()  const { return value().asFloat();  }
+        std::string         asString() const { return value().asString(); }
+        Value::BinaryType   asBinary() const { return value().asBinary(); }
+
+        /*!
+         * \brief returns the \a i'th item of an Array, scanning it on first access
+         * \throws value_exception if this isn't an Array, std::out_of_range if there is no such item
+         */
+        const LazyValue& operator [] (int i) const;
+
+        /*!
+         * \brief returns the item stored under \a key in a Map, scanning it on first access
+         * \throws value_exception if this isn't a Map, std::out_of_range if there is no such key
+         */
+        const LazyValue& operator [] (const std::string& key) const;
+        const LazyValue& operator [] (const char* key) const;
+
+        //! whether this is a Map with an item stored under \a key
+        bool contains(StringRef key) const noexcept;
+
+        //! the keys of a Map in document order; empty for every other type
+        Value::Keys keys() const;
+
+        //! iterates over the items of a Map or Array in document order; see const_iterator::key()
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        //! decodes this whole subtree once, and returns it
+        const Value& value() const;
+
+        /*!
+         * \brief the encoded bytes of this value, its marker included, for forwarding it as is.
+         * \note items of a homogenous Array share the Array's marker, so theirs are excluded
+         */
+        ByteSpan bytes() const noexcept { return encoded; }
+
+    private:
+        //! the byte range of an item found by the shallow scan, and the item itself once accessed
+        struct Item
+        {
+            StringRef key;
+            ByteSpan encoded;       //! from the marker, or the payload for items of homogenous Arrays
+            std::size_t payload;    //! offset of the payload within \a encoded
+            byte marker;
+            mutable std::unique_ptr<LazyValue> value;
+        };
+
+        LazyValue(ByteSpan encoded, std::size_t payload, byte marker, const ValueSizePolicy& policy);
+
+        std::size_t scan();
+        const LazyValue& item(std::size_t i) const;
+        const Item* find(StringRef key) const noexcept;
+        const LazyValue& member(StringRef key) const;
+
+        ByteSpan encoded;
+        std::size_t payload;    //! offset of the payload within \a encoded
+        byte marker;
+        Type vtype = Type::Null;
+        ValueSizePolicy vsz;
+
+        std::vector<Item> items;
+        mutable std::unique_ptr<Value> decoded;
+    };
+
+    /*!
+     * \brief The LazyValue::const_iterator class
+     * Walks the items of a Map or Array in document order; dereferencing scans the item
+     */
+    class LazyValue::const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LazyValue;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const LazyValue*;
+        using reference = const LazyValue&;
+
+        const_iterator(const LazyValue* Parent, std::size_t Index)
+            : parent(Parent), index(Index) {}
+
+        reference operator * () const { return parent->item(index); }
+        pointer operator -> () const { return &parent->item(index); }
+
+        //! the key of the current item if the iterated value is a Map, else an empty StringRef
+        StringRef key() const { return parent->items[index].key; }
+
+        const_iterator& operator ++ () { ++index; return *this; }
+        const_iterator operator ++ (int) { const_iterator rtn(*this); ++index; return rtn; }
+
+        bool operator == (const const_iterator& rhs) const { return parent == rhs.parent and index == rhs.index; }
+        bool operator != (const const_iterator& rhs) const { return not (*this == rhs); }
+
+    private:
+        const LazyValue* parent;
+        std::size_t index;
+    };
+
+}   //end namespace timl
+
+#endif // LAZY_VALUE_HPP
@@ -0,0 +1,167 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file mapped_file.hpp
+  * Read-only memory mapped files and a reader decoding the UBEX documents they contain
+  *
+  * @brief MappedFile and MappedFileReader
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cerrno>
+#include <system_error>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "byte_span.hpp"
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief The MappedFile class
+     * Maps a whole file read-only into memory for as long as it lives.
+     * Failures to open or map the file are reported by throwing std::system_error
+     */
+    class MappedFile
+    {
+    public:
+        enum class Access { Sequential, Random };
+
+        explicit MappedFile(const std::string& path, Access access = Access::Sequential)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if(fd < 0)
+                throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+
+            struct stat st;
+            if(::fstat(fd, &st) != 0)
+            {
+                const int err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), "Cannot stat " + path);
+            }
+
+            len = static_cast<std::size_t>(st.st_size);
+            if(len > 0)     //mmap() refuses empty mappings, an empty file is just an empty span
+            {
+                void* addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(addr == MAP_FAILED)
+                {
+                    const int err = errno;
+                    ::close(fd);
+                    throw std::system_error(err, std::generic_category(), "Cannot map " + path);
+                }
+                mapping = static_cast<const byte*>(addr);
+
+                //Only hints, the mapping is perfectly usable if the kernel ignores them
+                if(access == Access::Sequential)
+                    ::madvise(addr, len, MADV_SEQUENTIAL);
+                ::madvise(addr, len, MADV_WILLNEED);
+            }
+            ::close(fd);    //the mapping keeps its own reference to the file
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : mapping(other.mapping), len(other.len)
+        {
+            other.mapping = nullptr;
+            other.len = 0;
+        }
+
+        MappedFile& operator = (MappedFile&& other) noexcept
+        {
+            if(this != &other)
+            {
+                unmap();
+                mapping = other.mapping;
+                len = other.len;
+                other.mapping = nullptr;
+                other.len = 0;
+            }
+            return *this;
+        }
+
+        ~MappedFile() { unmap(); }
+
+        ByteSpan bytes() const noexcept { return ByteSpan(mapping, len); }
+        std::size_t size() const noexcept { return len; }
+
+    private:
+        void unmap() noexcept
+        {
+            if(mapping)
+                ::munmap(const_cast<byte*>(mapping), len);
+            mapping = nullptr;
+        }
+
+        const byte* mapping = nullptr;
+        std::size_t len = 0;
+    };
+
+
+    /*!
+     * \brief The MappedFileReader class
+     * Decodes the concatenated UBEX documents of a file straight out of its memory mapping.
+     *
+     * \code
+     * MappedFileReader reader("snapshot.ubex");
+     * Value v;
+     * while(reader.getNextValue(v))
+     *      consume(std::move(v));
+     * if(not reader.atEnd())
+     *      std::cerr << reader.getLastError() << std::endl;
+     * \endcode
+     */
+    class MappedFileReader
+    {
+    public:
+        explicit MappedFileReader(const std::string& path, ValueSizePolicy policy = defaultStreamReaderPolicy())
+            : file(path), span(file.bytes()), reader(span, policy) {}
+
+        MappedFileReader(const MappedFileReader&) = delete;
+        MappedFileReader& operator = (const MappedFileReader&) = delete;
+
+        //! decodes the next document, returns false on error or when there are no more documents
+        bool getNextValue(Value& v) { return reader.getNextValue(v); }
+
+        Value getNextValue() { return reader.getNextValue(); }
+
+        //! whether every document in the file has been consumed
+        bool atEnd() { return reader.atEnd(); }
+
+        std::size_t getBytesRead() const { return reader.getBytesRead(); }
+
+        std::string getLastError() const { return reader.getLastError(); }
+
+        const MappedFile& getFile() const { return file; }
+
+    private:
+        MappedFile file;
+        ByteSpan span;
+        BufferReader reader;
+    };
+
+}   //end namespace timl
+
+#endif // MAPPED_FILE_HPP
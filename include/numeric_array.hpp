@@ -0,0 +1,129 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file numeric_array.hpp
+  * A view over the payload of a homogenous Array of numbers, decoded in bulk
+  *
+  * @brief NumericArray
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef NUMERIC_ARRAY_HPP
+#define NUMERIC_ARRAY_HPP
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "types.hpp"
+#include "byte_span.hpp"
+#include "stream_helpers.hpp"
+
+namespace timl {
+
+    //! whether a homogenous Array of \a type_mark items is decoded in bulk, see NumericArray
+    constexpr bool isBulkNumeric(byte type_mark)
+    {
+        return markerInfo(type_mark).kind == MarkerKind::SignedInt
+            or markerInfo(type_mark).kind == MarkerKind::UnsignedInt
+            or markerInfo(type_mark).kind == MarkerKind::Float;
+    }
+
+    /*!
+     * \brief The NumericArray class
+     * The items of a homogenous Array of integers or floats, still big endian, exactly as they
+     * were encoded. Like ByteSpan, it never owns them.
+     *
+     * \code
+     * std::vector<float> samples(numbers.size());
+     * numbers.copyTo(samples.data());          // one bulk byteswap when the marker is Float32
+     * \endcode
+     */
+    class NumericArray
+    {
+    public:
+        //! \pre isBulkNumeric(marker), and \a payload holds a whole number of items
+        NumericArray(byte marker, ByteSpan payload) noexcept
+            : mark(marker), bytes(payload) {}
+
+        //! the marker every item shares
+        byte marker() const noexcept { return mark; }
+
+        //! the Type each item decodes to
+        Type type() const noexcept { return markerInfo(mark).type; }
+
+        std::size_t size() const noexcept { return bytes.size() / markerInfo(mark).width; }
+
+        //! the encoded, big endian, items
+        ByteSpan payload() const noexcept { return bytes; }
+
+        /*!
+         * \brief decodes every item into \a out, which must have room for size() of them.
+         * Items are converted with static_cast, so pick a \a T that holds them losslessly
+         */
+        template<typename T>
+        void copyTo(T* out) const
+        {
+            switch (static_cast<Marker>(mark)) {
+            case Marker::Int8:      return decode<int8_t>(out);
+            case Marker::Int16:     return decode<int16_t>(out);
+            case Marker::Int32:     return decode<int32_t>(out);
+            case Marker::Int64:     return decode<int64_t>(out);
+            case Marker::Uint8:     return decode<uint8_t>(out);
+            case Marker::Uint16:    return decode<uint16_t>(out);
+            case Marker::Uint32:    return decode<uint32_t>(out);
+            case Marker::Uint64:    return decode<uint64_t>(out);
+            case Marker::Float32:   return decode<float>(out);
+            case Marker::Float64:   return decode<double>(out);
+            default:                return;
+            }
+        }
+
+        template<typename T>
+        std::vector<T> toVector() const
+        {
+            std::vector<T> rtn(size());
+            copyTo(rtn.data());
+            return rtn;
+        }
+
+    private:
+        //! items already of type \a T are byteswapped straight into \a out
+        template<typename Encoded, typename T>
+        typename std::enable_if<std::is_same<Encoded, T>::value>::type decode(T* out) const
+        { fromBigEndianArray(bytes.data(), size(), out); }
+
+        //! others go through a small buffer, a block at a time
+        template<typename Encoded, typename T>
+        typename std::enable_if<not std::is_same<Encoded, T>::value>::type decode(T* out) const
+        {
+            Encoded block[256];
+            const std::size_t n = size();
+            for(std::size_t done = 0; done < n; )
+            {
+                const std::size_t chunk = std::min<std::size_t>(n - done, 256);
+                fromBigEndianArray(bytes.data() + done * sizeof(Encoded), chunk, block);
+                for(std::size_t i = 0; i < chunk; ++i)
+                    out[done + i] = static_cast<T>(block[i]);
+                done += chunk;
+            }
+        }
+
+        byte mark;
+        ByteSpan bytes;
+    };
+
+}   //end namespace timl
+
+#endif // NUMERIC_ARRAY_HPP
@@ -0,0 +1,142 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file parallel_document_reader.hpp
+  * Decodes the back to back documents of a buffer on a pool of threads
+  *
+  * @brief ParallelDocumentReader
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef PARALLEL_DOCUMENT_READER_HPP
+#define PARALLEL_DOCUMENT_READER_HPP
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <string>
+#include <condition_variable>
+#include "value.hpp"
+#include "byte_span.hpp"
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    //! How a ParallelDocumentReader spreads its work
+    struct ParallelReaderOptions
+    {
+        std::size_t threads;    //!< decoding threads; 0 for one per hardware thread
+        bool ordered;           //!< whether documents come back in the order they are stored
+    };
+
+    constexpr ParallelReaderOptions defaultParallelReaderOptions()
+    { return {0, true}; }
+
+    /*!
+     * \brief The ParallelDocumentReader class
+     * Decodes the Objects stored back to back in a buffer, e.g a MappedFile of records, on a pool of threads.
+     * One thread finds where each document ends by stepping over it, without decoding (see
+     * StreamReader::skipNextValue()); batches of documents are then decoded by the others.
+     *
+     * \code
+     * MappedFile file("ingest.ubex");
+     * ParallelDocumentReader reader(file.bytes(), ParallelReaderOptions{16, false});
+     * Value record;
+     * while(reader.next(record))
+     *      process(record);
+     * if(reader.failed())
+     *      std::cerr << reader.getLastError() << '\n';
+     * \endcode
+     *
+     * Unordered, documents come back as soon as their batch is decoded; their order within a batch is kept.
+     * Reading stops at the first malformed document. In order, every document before it is returned first;
+     * unordered, documents of other batches may be left out. Only a bounded number of decoded batches is held
+     * at once, so the consumer sets the pace. The bytes must outlive the reader; next() is not thread safe.
+     */
+    class ParallelDocumentReader
+    {
+    public:
+        explicit ParallelDocumentReader(ByteSpan documents,
+                                        ParallelReaderOptions options = defaultParallelReaderOptions(),
+                                        ValueSizePolicy policy = defaultStreamReaderPolicy());
+
+        ParallelDocumentReader(const ParallelDocumentReader&) = delete;
+        ParallelDocumentReader& operator = (const ParallelDocumentReader&) = delete;
+
+        //! stops and joins the threads, whether or not every document was read
+        ~ParallelDocumentReader();
+
+        /*!
+         * \brief moves the next decoded document into \a v
+         * \return false once every document was returned, or at a malformed one; see failed()
+         */
+        bool next(Value& v);
+
+        //! whether reading stopped at a malformed document rather than the end of the buffer
+        bool failed() const noexcept { return not last_error.empty(); }
+
+        std::string getLastError() const { return last_error; }
+
+        //! the number of decoding threads
+        std::size_t threads() const noexcept { return workers.size(); }
+
+    private:
+        //! consecutive documents, decoded together to keep the threads' handoffs rare
+        struct Batch
+        {
+            std::size_t seq;
+            ByteSpan bytes;                 //! the batch's documents, back to back
+            std::size_t count = 0;
+            std::vector<Value> values;      //! the decoded documents, up to the first malformed one
+            std::string error;
+            std::size_t taken = 0;          //! values already handed to next()
+        };
+
+        void scan();
+        void decode();
+        std::unique_ptr<Batch> wait_for_batch();
+
+        const ByteSpan bytes;
+        const ValueSizePolicy vsz;
+        const bool ordered;
+        const std::size_t max_batches;      //! batches scanned but not yet consumed, at most
+
+        std::mutex mutex;
+        std::condition_variable jobs_cv;    //! signals workers: a batch to decode, or stopping
+        std::condition_variable done_cv;    //! signals next(): a decoded batch, or the end of scanning
+        std::condition_variable room_cv;    //! signals the scanner: a batch was consumed, or stopping
+        std::deque<std::unique_ptr<Batch>> jobs;
+        std::map<std::size_t, std::unique_ptr<Batch>> decoded;
+        std::size_t in_flight = 0;
+        std::size_t scanned = 0;            //! batches the scanner produced
+        bool scan_done = false;
+        bool stopping = false;
+        std::string scan_error;
+
+        std::unique_ptr<Batch> current;
+        std::size_t next_seq = 0;
+        std::string last_error;
+        bool finished = false;
+
+        std::thread scanner;
+        std::vector<std::thread> workers;
+    };
+
+}   //end namespace timl
+
+#endif // PARALLEL_DOCUMENT_READER_HPP
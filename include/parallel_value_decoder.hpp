@@ -0,0 +1,115 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file parallel_value_decoder.hpp
+  * Decodes the large Arrays of a single document on a pool of threads
+  *
+  * @brief ParallelValueDecoder
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef PARALLEL_VALUE_DECODER_HPP
+#define PARALLEL_VALUE_DECODER_HPP
+
+#include <string>
+#include <vector>
+#include "value.hpp"
+#include "byte_span.hpp"
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    //! How a ParallelValueDecoder spreads its work
+    struct ParallelDecodeOptions
+    {
+        std::size_t threads;    //!< decoding threads, the calling one included; 0 for one per hardware thread
+        std::size_t min_items;  //!< Arrays with fewer items are decoded on the calling thread alone
+    };
+
+    constexpr ParallelDecodeOptions defaultParallelDecodeOptions()
+    { return {0, 64*1024}; }
+
+    /*!
+     * \brief The ParallelValueDecoder class
+     * Decodes a single document whose members are large Arrays, e.g an Object holding millions of samples,
+     * on several threads. Each member Array holding at least ParallelDecodeOptions::min_items is stepped over
+     * first, without decoding, to split its items into chunks of consecutive items; Objects carrying a Width hint
+     * are stepped over whole. The chunks are then decoded on the threads, and stitched back into the Array in order.
+     * Every other member is decoded on the calling thread, just as StreamReader::getNextValue() does.
+     *
+     * \code
+     * MappedFile file("capture.ubex");
+     * ParallelValueDecoder decoder(ParallelDecodeOptions{8, 100000});
+     * Value capture;
+     * if(not decoder.decode(file.bytes(), capture))
+     *      std::cerr << decoder.getLastError() << '\n';
+     * \endcode
+     *
+     * The result is the Value getNextValue() decodes from the same bytes, and a document it rejects is rejected
+     * too, though not always with the same message. Only members of the document itself are split; Arrays nested
+     * deeper are decoded whole, by whichever thread decodes their parent. The bytes must outlive decode(), not the
+     * decoded Value.
+     */
+    class ParallelValueDecoder
+    {
+    public:
+        explicit ParallelValueDecoder(ParallelDecodeOptions options = defaultParallelDecodeOptions(),
+                                      ValueSizePolicy policy = defaultStreamReaderPolicy());
+
+        /*!
+         * \brief decodes the Object at the start of \a document into \a v
+         * \return false if the Object is malformed or violates the ValueSizePolicy, see getLastError();
+         * \a v is then left as it was
+         */
+        bool decode(ByteSpan document, Value& v);
+
+        //! the bytes the last decoded Object took, from the start of its document
+        std::size_t getBytesRead() const noexcept { return bytes_read; }
+
+        std::string getLastError() const { return last_error; }
+
+        //! the number of decoding threads, the calling one included
+        std::size_t threads() const noexcept { return thread_count; }
+
+    private:
+        //! consecutive items of an Array, decoded together by one thread
+        struct Chunk
+        {
+            ByteSpan bytes;
+            std::size_t count;
+            bool shared_mark;       //! whether the items are those of a HomoArray, sharing type_mark
+            byte type_mark;
+            Value items;            //! an Array of the decoded items, Null if there are none
+            std::string error;
+            ParseError code;
+        };
+
+        bool decode_array(BufferReader& reader, ByteSpan document, byte marker, Value& v);
+        std::vector<Chunk> split_array(BufferReader& reader, ByteSpan document, const ContainerFrame& f);
+        void decode_chunk(Chunk& chunk) const;
+
+        const std::size_t thread_count;
+        const std::size_t min_items;
+        const ValueSizePolicy vsz;
+        const ValueSizePolicy member_vsz;   //! the policy a member of the document is decoded with, on its own
+        const ValueSizePolicy item_vsz;     //! and the policy an item of one of its Arrays is decoded with
+
+        std::size_t bytes_read = 0;
+        std::string last_error;
+    };
+
+}   //end namespace timl
+
+#endif // PARALLEL_VALUE_DECODER_HPP
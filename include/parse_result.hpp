@@ -0,0 +1,80 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file parse_result.hpp
+  * Error codes for documents that can't be decoded
+  *
+  * @brief ParseError, ParseResult
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef PARSE_RESULT_HPP
+#define PARSE_RESULT_HPP
+
+#include <cstddef>
+
+namespace timl {
+
+    //! Why a document can't be decoded
+    enum class ParseError : unsigned char
+    {
+        None,
+        UnexpectedEnd,      //!< the source ends in the middle of the Object
+        NotAnObject,        //!< the source doesn't start with an Object
+        UnknownMarker,      //!< a byte that introduces no value, where a value is expected
+        InvalidCount,       //!< a String or Binary whose size has no count marker
+        IllFormedHeader,    //!< a container header that is neither a count nor its end marker, or a bad Width hint
+        MissingEnd,         //!< a container not closed by its end marker after its last item
+        WidthMismatch,      //!< a Width hint that doesn't match the size of its Object
+        TooDeep,            //!< containers nesting beyond ValueSizePolicy::max_value_depth
+        ObjectTooLarge,     //!< an Object beyond ValueSizePolicy::max_object_size
+        StringTooLarge,     //!< a String beyond ValueSizePolicy::max_string_size
+        BinaryTooLarge,     //!< a Binary beyond ValueSizePolicy::max_binary_size
+        Malformed           //!< any other error
+    };
+
+    //! a message for \a code, the one StreamReader::getLastError() reports for it where it has no details to add
+    constexpr const char* describeError(ParseError code)
+    {
+        switch (code) {
+        case ParseError::None:              return "";
+        case ParseError::UnexpectedEnd:     return "Unexpected end of Stream";
+        case ParseError::NotAnObject:       return "Stream does not contain a valid Object - ObjectStartMarker";
+        case ParseError::UnknownMarker:     return "Unknown value marker encountered!";
+        case ParseError::InvalidCount:      return "Invalid count token encounted!";
+        case ParseError::IllFormedHeader:   return "Ill formed object!";
+        case ParseError::MissingEnd:        return "Object is incomplete otherwise corrupt";
+        case ParseError::WidthMismatch:     return "Width hint does not match the Object's size";
+        case ParseError::TooDeep:           return "Maximum Parsing depth Exceeded!";
+        case ParseError::ObjectTooLarge:    return "Maximum Object size exceeded";
+        case ParseError::StringTooLarge:    return "Maximum String size exceeded";
+        case ParseError::BinaryTooLarge:    return "Maximum Binary size exceeded";
+        default:                            return "Malformed Object";
+        }
+    }
+
+    //! How decoding, or checking, a document went
+    struct ParseResult
+    {
+        ParseError code;
+        std::size_t offset;     //!< the bytes the Object took if it is good, else how far into it the error is
+
+        explicit operator bool () const noexcept { return code == ParseError::None; }
+        const char* message() const noexcept { return describeError(code); }
+    };
+
+}   //end namespace timl
+
+#endif // PARSE_RESULT_HPP
@@ -0,0 +1,161 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file push_parser.hpp
+  * Decodes documents from bytes handed over as they arrive, e.g off a non-blocking socket
+  *
+  * @brief PushParser
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef PUSH_PARSER_HPP
+#define PUSH_PARSER_HPP
+
+#include <vector>
+#include <string>
+#include "value.hpp"
+#include "byte_span.hpp"
+#include "parse_result.hpp"
+#include "event_handler.hpp"
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief The PushParser class
+     * A resumable decoder: rather than pulling bytes from a stream, it is fed whatever bytes have arrived,
+     * in fragments as small as one byte. Where it stopped is kept across calls, so each byte is looked at
+     * once, however the document is split; only a token straddling two fragments is copied aside.
+     *
+     * \code
+     * PushParser parser;
+     * byte buf[4096];
+     * while((n = recv(fd, buf, sizeof buf, 0)) > 0)
+     * {
+     *      ByteSpan bytes(buf, n);
+     *      while(not bytes.empty())
+     *      {
+     *          PushParser::Progress p = parser.feed(bytes);
+     *          bytes = bytes.subspan(p.consumed);
+     *          if(p.status == PushParser::Complete)
+     *              process(parser.take());
+     *          else if(p.status == PushParser::Error)
+     *              return drop(fd, parser.error());
+     *      }
+     * }
+     * \endcode
+     *
+     * feed() stops right after the end of an Object, so that the bytes of the next one are left to the caller.
+     * The ValueSizePolicy is enforced as StreamReader::getNextValue() does, including max_object_size, which is
+     * what keeps a peer from making the parser buffer without end.
+     */
+    class PushParser
+    {
+    public:
+        enum Status { NeedMore, Complete, Error };
+
+        //! How far a call to feed() went
+        struct Progress
+        {
+            Status status;
+            std::size_t consumed;   //!< the bytes fed that were used; less than given only for Complete or Error
+        };
+
+        explicit PushParser(ValueSizePolicy policy = defaultStreamReaderPolicy());
+
+        PushParser(const PushParser&) = delete;
+        PushParser& operator = (const PushParser&) = delete;
+
+        /*!
+         * \brief decodes as much of the current Object as \a size bytes at \a data allow
+         * Once an Object is Complete, the next call starts over with a new one. Once in Error,
+         * every call returns Error without looking at its bytes, until reset()
+         */
+        Progress feed(const byte* data, std::size_t size);
+        Progress feed(ByteSpan bytes) { return feed(bytes.data(), bytes.size()); }
+
+        //! the Object that just completed, or the part decoded so far of the one in progress
+        Value& value() { return root; }
+
+        //! moves out the Object that just completed
+        Value take() { return std::move(root); }
+
+        //! what is wrong with the Object, and how far into it
+        ParseResult error() const { return ParseResult{last_code, last_code == ParseError::None ? bytes_so_far : error_at}; }
+
+        std::string getLastError() const { return describeError(last_code); }
+
+        //! the bytes of the current Object fed so far
+        std::size_t getBytesRead() const { return bytes_so_far; }
+
+        //! drops the Object in progress, if any, along with an Error
+        void reset();
+
+    private:
+        //! what the next bytes are expected to be
+        enum class Step : unsigned char
+        {
+            Root, Header, Key, KeyBytes, Value, Scalar, SequenceSize, SequenceBytes, End, Done, Failed
+        };
+
+        struct Frame
+        {
+            byte end;               //! the marker that closes the container
+            bool keyed;             //! Objects have a key before each item
+            byte type_mark;         //! the marker shared by the items of a HomoArray, 0 if each has its own
+            std::size_t remaining;  //! items not yet started
+        };
+
+        std::size_t position() const noexcept { return bytes_so_far + static_cast<std::size_t>(in - fragment); }
+        void go(Step next) noexcept { step = next; step_start = position(); }
+        const byte* take(std::size_t sz);
+        bool take_count(std::pair<std::size_t, bool>& icount);
+        bool header();
+        bool close_header(std::pair<std::size_t, bool> icount);
+        void next_item();
+        void scalar(const byte* payload);
+        bool fail(ParseError code, std::size_t at);
+        Progress stall();
+
+        const ValueSizePolicy vsz;
+        Value root;
+        ValueBuilder builder;
+
+        Step step = Step::Root;
+        std::vector<Frame> stack;
+
+        const byte* fragment = nullptr;     //! the bytes being fed
+        const byte* in = nullptr;           //! the next unread one
+        const byte* in_end = nullptr;       //! clamped to what the ValueSizePolicy still allows
+        bool clamped = false;
+        std::string pending;                //! the start of a token that straddles fragments
+        bool pending_used = false;          //! whether pending holds a whole token, already handed out
+
+        byte marker = 0;                    //! of the value being decoded
+        byte header_step = 0;               //! how far into a container header, \see header()
+        byte type_mark = 0;                 //! of the HomoArray whose header is being read
+        byte count_marker = 0;              //! of the count being read
+        bool has_count_marker = false;
+        std::size_t wanted = 0;             //! the size of a key, String or Binary, or of a Width hint
+        std::size_t width_start = 0;        //! the offset a Width hint counts from
+        std::size_t step_start = 0;         //! the offset the bytes of the current step start at
+        std::size_t bytes_so_far = 0;       //! of the current Object, up to the fragment being fed
+        std::size_t error_at = 0;
+        ParseError last_code = ParseError::None;
+    };
+
+}   //end namespace timl
+
+#endif // PUSH_PARSER_HPP
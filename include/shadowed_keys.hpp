@@ -0,0 +1,87 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file shadowed_keys.hpp
+  * Drops the items of a decoded Map that a later item under the same key replaces, as Value does
+  *
+  * @brief dropShadowed
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef SHADOWED_KEYS_HPP
+#define SHADOWED_KEYS_HPP
+
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include "byte_span.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief removes every one of the \a n \a items whose key, as given by \a key_of, is given again further on.
+     * The others are moved to the front, in the order they came. \a order is scratch room, reused across calls
+     * \return the items kept
+     */
+    template<typename Item, typename KeyOf>
+    std::size_t dropShadowed(Item* items, std::size_t n, std::vector<std::size_t>& order, KeyOf key_of)
+    {
+        if(n < 2)
+            return n;
+        if(n <= 16)     //the usual Map, where comparing every pair is cheaper than sorting
+        {
+            bool repeated = false;
+            for(std::size_t i = 0; i < n and not repeated; ++i)
+                for(std::size_t j = i + 1; j < n and not repeated; ++j)
+                    repeated = key_of(items[i]) == key_of(items[j]);
+            if(not repeated)
+                return n;
+        }
+
+        order.resize(n);
+        for(std::size_t i = 0; i < n; ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            const StringRef x = key_of(items[a]), y = key_of(items[b]);
+            if(x.size() != y.size())
+                return x.size() < y.size();
+            const int c = x.empty() ? 0 : std::memcmp(x.data(), y.data(), x.size());
+            return c != 0 ? c < 0 : a < b;
+        });
+
+        //the shadowed ones are those followed by the same key in order; they are gathered at its front
+        std::size_t shadowed = 0;
+        for(std::size_t k = 0; k + 1 < n; ++k)
+            if(key_of(items[order[k]]) == key_of(items[order[k + 1]]))
+                order[shadowed++] = order[k];
+        if(shadowed == 0)
+            return n;
+
+        std::sort(order.begin(), order.begin() + shadowed);
+        std::size_t kept = 0;
+        for(std::size_t i = 0, s = 0; i < n; ++i)
+        {
+            if(s < shadowed and order[s] == i)
+                ++s;
+            else if(kept++ != i)
+                items[kept - 1] = std::move(items[i]);
+        }
+        return kept;
+    }
+
+}   //end namespace timl
+
+#endif // SHADOWED_KEYS_HPP
@@ -5,7 +5,9 @@
 #include <cstring>
 #include <endian.h>
 #include <limits>
+#include <type_traits>
 #include "types.hpp"
+#include "endian_kernels.hpp"
 
 namespace timl{
 
@@ -19,6 +21,7 @@ namespace timl{
 
     inline byte* to_byte(cbyte* b) { return reinterpret_cast<byte*>(b); }
     inline cbyte* to_cbyte(byte* b) { return reinterpret_cast<cbyte*>(b); }
+    inline const cbyte* to_cbyte(const byte* b) { return reinterpret_cast<const cbyte*>(b); }
 
     struct KeyMarker
     {
@@ -31,23 +34,23 @@ namespace timl{
     { return (min <= value and value <= max); }
 
 
-    uint16_t toBigEndian16(uint16_t val)
+    inline uint16_t toBigEndian16(uint16_t val)
     {  return htobe16(val); }
 
-    uint32_t toBigEndian32(uint32_t val)
+    inline uint32_t toBigEndian32(uint32_t val)
     {  return htobe32(val); }
 
-    uint64_t toBigEndian64(uint64_t val)
+    inline uint64_t toBigEndian64(uint64_t val)
     {  return htobe64(val); }
 
-    uint32_t toBigEndianFloat32(float val)
+    inline uint32_t toBigEndianFloat32(float val)
     {
         uint32_t rtn;
         std::memcpy(&rtn, &val, sizeof(rtn));
         return toBigEndian32( rtn );
     }
 
-    uint64_t toBigEndianFloat64(double val)
+    inline uint64_t toBigEndianFloat64(double val)
     {
         uint64_t rtn;
         std::memcpy(&rtn, &val, sizeof(rtn));
@@ -56,16 +59,16 @@ namespace timl{
 
 
 
-    uint16_t fromBigEndian16(uint16_t val)
+    inline uint16_t fromBigEndian16(uint16_t val)
     {  return be16toh(val); }
 
-    uint32_t fromBigEndian32(uint32_t val)
+    inline uint32_t fromBigEndian32(uint32_t val)
     {  return be32toh(val); }
 
-    uint64_t fromBigEndian64(uint64_t val)
+    inline uint64_t fromBigEndian64(uint64_t val)
     {  return be64toh(val); }
 
-    float fromBigEndianFloat32(uint32_t val)
+    inline float fromBigEndianFloat32(uint32_t val)
     {
         float rtn;
         val = fromBigEndian32(val);
@@ -73,7 +76,7 @@ namespace timl{
         return rtn;
     }
 
-    double fromBigEndianFloat64(uint64_t val)
+    inline double fromBigEndianFloat64(uint64_t val)
     {
         double rtn;
         val = fromBigEndian64(val);
@@ -90,33 +93,33 @@ namespace timl{
     ///////////////////////////////////////
 
 
-    uint8_t fromBigEndian8(byte* b)
+    inline uint8_t fromBigEndian8(byte* b)
     {
         return *b;
     }
 
-    uint16_t fromBigEndian16(byte* b)
+    inline uint16_t fromBigEndian16(byte* b)
     {
         uint16_t rtn;
         std::memcpy(&rtn, b, 2);
         return fromBigEndian16(rtn);
     }
 
-    uint32_t fromBigEndian32(byte* b)
+    inline uint32_t fromBigEndian32(byte* b)
     {
         uint32_t rtn;
         std::memcpy(&rtn, b, 4);
         return fromBigEndian32(rtn);
     }
 
-    uint64_t fromBigEndian64(byte* b)
+    inline uint64_t fromBigEndian64(byte* b)
     {
         uint64_t rtn;
         std::memcpy(&rtn, b, 8);
         return fromBigEndian64(rtn);
     }
 
-    float fromBigEndianFloat32(byte* b)
+    inline float fromBigEndianFloat32(byte* b)
     {
         float rtn;
         const uint32_t ans = fromBigEndian32(b);
@@ -124,7 +127,7 @@ namespace timl{
         return rtn;
     }
 
-    double fromBigEndianFloat64(byte* b)
+    inline double fromBigEndianFloat64(byte* b)
     {
         double rtn;
         const int64_t ans = fromBigEndian64(b);
@@ -132,6 +135,50 @@ namespace timl{
         return rtn;
     }
 
+
+
+    ////////////////////////////////////
+    ///
+    /// Bulk conversions, for the payloads of homogenous Arrays
+    ///
+    ///////////////////////////////////////
+
+    template<std::size_t Size> struct uint_of_size;
+    template<> struct uint_of_size<1> { using type = uint8_t; };
+    template<> struct uint_of_size<2> { using type = uint16_t; };
+    template<> struct uint_of_size<4> { using type = uint32_t; };
+    template<> struct uint_of_size<8> { using type = uint64_t; };
+
+    inline uint8_t fromBigEndian(uint8_t val) { return val; }
+    inline uint16_t fromBigEndian(uint16_t val) { return fromBigEndian16(val); }
+    inline uint32_t fromBigEndian(uint32_t val) { return fromBigEndian32(val); }
+    inline uint64_t fromBigEndian(uint64_t val) { return fromBigEndian64(val); }
+
+    /*!
+     * decodes \a n big endian values of type \a T, packed back to back at \a src, into \a out.
+     * Short runs are a plain loop; longer ones go to the vector kernels of endianKernels()
+     */
+    template<typename T>
+    inline void fromBigEndianArray(const byte* src, std::size_t n, T* out)
+    {
+        static_assert(std::is_arithmetic<T>::value, "only numbers are stored big endian");
+        using U = typename uint_of_size<sizeof(T)>::type;
+        if(sizeof(T) > 1 and n * sizeof(T) >= 64)
+        {
+            const EndianKernels& k = endianKernels();
+            auto swap = sizeof(T) == 2 ? k.swap16 : (sizeof(T) == 4 ? k.swap32 : k.swap64);
+            swap(src, n, reinterpret_cast<byte*>(out));
+            return;
+        }
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            U v;
+            std::memcpy(&v, src + i * sizeof(T), sizeof(T));
+            v = fromBigEndian(v);
+            std::memcpy(out + i, &v, sizeof(T));
+        }
+    }
+
 }
 
 #endif // CONVERSIONS_HPP
@@ -15,303 +15,893 @@
 #define STREAM_READER_HPP
 
 #include "stream_helpers.hpp"
+#include "byte_span.hpp"
+#include "event_handler.hpp"
+#include "numeric_array.hpp"
 #include "value.hpp"
+#include "document.hpp"
+#include "parse_result.hpp"
 #include <fstream>
 #include <cstring>
 #include <tuple>
+#include <memory>
+#include <algorithm>
 #include <iostream>
+#include <type_traits>
 
 namespace timl {
 
-    enum class MarkerType { Object, HetroArray, HomoArray };
+    enum class MarkerType : byte { Object, HetroArray, HomoArray };
+
+    //! Book keeping for a container whose items are being walked through
+    struct ContainerFrame
+    {
+        MarkerType type;
+        byte type_mark;         //! the marker shared by all items of a HomoArray
+        bool end_consumed;      //! empty containers have no count, their end marker is read upfront
+        std::size_t remaining;  //! items not yet read
+    };
 
     constexpr ValueSizePolicy defaultStreamReaderPolicy()
-    { return {32, 1024*1024*64, 1024*1024*8, 1024*1024*65, 1024, 1024}; }
+    { return {1024, 1024*1024*64, 1024*1024*8, 1024*1024*65, 1024, 1024}; }
+
+    /*!
+     * \brief A ValueSizePolicy fixed at compile time, for a StreamReader's \a SizePolicy
+     * The limits are constants the compiler folds into every check made against them, and checks
+     * against std::numeric_limits<std::size_t>::max() can never fail, so they go away entirely
+     * \see UncheckedSizePolicy
+     */
+    template<std::size_t MaxDepth, std::size_t MaxBinary, std::size_t MaxString, std::size_t MaxObject,
+             std::size_t MaxArrayItems = 1024, std::size_t MaxObjectItems = 1024>
+    struct StaticSizePolicy
+    {
+        static constexpr std::size_t max_value_depth = MaxDepth;
+        static constexpr std::size_t max_binary_size = MaxBinary;
+        static constexpr std::size_t max_string_size = MaxString;
+        static constexpr std::size_t max_object_size = MaxObject;
+        static constexpr std::size_t max_array_items = MaxArrayItems;
+        static constexpr std::size_t max_object_items = MaxObjectItems;
+
+        constexpr operator ValueSizePolicy() const
+        { return {MaxDepth, MaxBinary, MaxString, MaxObject, MaxArrayItems, MaxObjectItems}; }
+    };
+
+    template<std::size_t D, std::size_t B, std::size_t S, std::size_t O, std::size_t A, std::size_t I>
+    constexpr std::size_t StaticSizePolicy<D, B, S, O, A, I>::max_value_depth;
+    template<std::size_t D, std::size_t B, std::size_t S, std::size_t O, std::size_t A, std::size_t I>
+    constexpr std::size_t StaticSizePolicy<D, B, S, O, A, I>::max_binary_size;
+    template<std::size_t D, std::size_t B, std::size_t S, std::size_t O, std::size_t A, std::size_t I>
+    constexpr std::size_t StaticSizePolicy<D, B, S, O, A, I>::max_string_size;
+    template<std::size_t D, std::size_t B, std::size_t S, std::size_t O, std::size_t A, std::size_t I>
+    constexpr std::size_t StaticSizePolicy<D, B, S, O, A, I>::max_object_size;
+    template<std::size_t D, std::size_t B, std::size_t S, std::size_t O, std::size_t A, std::size_t I>
+    constexpr std::size_t StaticSizePolicy<D, B, S, O, A, I>::max_array_items;
+    template<std::size_t D, std::size_t B, std::size_t S, std::size_t O, std::size_t A, std::size_t I>
+    constexpr std::size_t StaticSizePolicy<D, B, S, O, A, I>::max_object_items;
+
+    //! defaultStreamReaderPolicy(), fixed at compile time
+    using DefaultStaticSizePolicy = StaticSizePolicy<1024, 1024*1024*64, 1024*1024*8, 1024*1024*65>;
+
+    /*!
+     * \brief No limits at all, for trusted peers only, such as our own writers over loopback.
+     * Malformed Objects are still rejected; yet an Object announcing huge sizes is taken at its word.
+     * The item counts only cap how much a container reserves upfront, so they stay as they are
+     */
+    using UncheckedSizePolicy = StaticSizePolicy<std::size_t(-1), std::size_t(-1), std::size_t(-1), std::size_t(-1)>;
+
+    //! the limits a StreamReader enforces when none are given
+    template<typename SizePolicy>
+    constexpr SizePolicy defaultSizePolicy()
+    { return SizePolicy{}; }
+
+    template<>
+    constexpr ValueSizePolicy defaultSizePolicy<ValueSizePolicy>()
+    { return defaultStreamReaderPolicy(); }
+
+    //! Size of the block StreamReader pulls from its source at a time. 0 disables buffering
+    constexpr std::size_t defaultReadBufferSize()
+    { return 64*1024; }
+
+    //! \see validate.hpp
+    ParseResult validate(ByteSpan bytes, const ValueSizePolicy& policy);
+
+
+    /*!
+     * \brief Describes how StreamReader pulls raw bytes out of a StreamType
+     *
+     * The generic version expects the \a StreamType to model a \e read_some concept,
+     * \code std::size_t read_some(byte* buffer, std::size_t size); \endcode
+     * returning the number of bytes actually read (0 on end of stream).
+     * and a blocking \code void read(char* buffer, std::size_t size); \endcode for unbuffered reading.
+     * Standard streams are served directly from their \e std::streambuf.
+     *
+     * A \e contiguous source (see ByteSpan) is decoded in place; the reader never copies it into a buffer
+     */
+    template<typename StreamType, bool = std::is_base_of<std::ios_base, StreamType>::value>
+    struct stream_source
+    {
+        static constexpr bool contiguous = false;
+
+        static std::size_t read_some(StreamType& stream, byte* b, std::size_t sz)
+        { return stream.read_some(b, sz); }
+
+        //! \return false if the stream ended short of \a sz bytes; the concept's read() has no way to tell
+        static bool read(StreamType& stream, byte* b, std::size_t sz)
+        { stream.read(to_cbyte(b), sz); return true; }
+
+        static bool at_end(StreamType& stream)
+        { return stream.eof(); }
+    };
 
     template<typename StreamType>
+    struct stream_source<StreamType, true>
+    {
+        static constexpr bool contiguous = false;
+
+        static std::size_t read_some(StreamType& stream, byte* b, std::size_t sz)
+        {
+            const auto got = stream.rdbuf()->sgetn(to_cbyte(b), static_cast<std::streamsize>(sz));
+            if(got < static_cast<std::streamsize>(sz))
+                stream.setstate(std::ios_base::eofbit);
+            return got < 0 ? 0 : static_cast<std::size_t>(got);
+        }
+
+        static bool read(StreamType& stream, byte* b, std::size_t sz)
+        {
+            stream.read(to_cbyte(b), static_cast<std::streamsize>(sz));
+            return stream.gcount() == static_cast<std::streamsize>(sz);
+        }
+
+        static bool at_end(StreamType& stream)
+        { return StreamType::traits_type::eq_int_type(stream.rdbuf()->sgetc(), StreamType::traits_type::eof()); }
+    };
+
+    template<>
+    struct stream_source<ByteSpan, false>
+    {
+        static constexpr bool contiguous = true;
+
+        static const byte* data(const ByteSpan& span) { return span.data(); }
+        static std::size_t size(const ByteSpan& span) { return span.size(); }
+
+        //! the whole span is visible to the reader, there is never anything more to read
+        static std::size_t read_some(ByteSpan&, byte*, std::size_t) { return 0; }
+
+        static bool read(ByteSpan&, byte*, std::size_t)
+        { return false; }
+
+        static bool at_end(ByteSpan&)
+        { return true; }
+    };
+
+    template<typename StreamType, typename SizePolicy = ValueSizePolicy>
+    class UbexCursor;
+
+    class LazyValue;
+    class ParallelValueDecoder;
+
+    /*!
+     * \brief Decodes the Objects of a StreamType, one at a time
+     * \a SizePolicy holds the limits decoding is checked against: a ValueSizePolicy chosen at run time,
+     * a StaticSizePolicy fixed at compile time, or UncheckedSizePolicy, whose checks compile away
+     */
+    template<typename StreamType, typename SizePolicy = ValueSizePolicy>
     class StreamReader
     {
+        friend class UbexCursor<StreamType, SizePolicy>;
+        friend class LazyValue;             //! both decode with a BufferReader and the run time ValueSizePolicy they are given
+        friend class ParallelValueDecoder;
     public:
 
         struct policy_violation : parsing_exception
         {
-            policy_violation(const std::string& str) : parsing_exception(""), ss(str) {}
+            policy_violation(const std::string& str, ParseError code) : parsing_exception("", code), ss(str) {}
             const char* what() const noexcept { return ss.c_str(); }
             std::string ss;
         };
 
 
-        StreamReader(StreamType& Stream, ValueSizePolicy policy = defaultStreamReaderPolicy());
+        /*!
+         * \brief constructs a reader pulling from \a Stream
+         * \param buffer_size the reader pulls \a buffer_size bytes at a time from \a Stream and
+         * decodes from its own buffer. Hence, \a Stream may be read past the end of the current Value.
+         * Pass 0 to read exactly what each Value needs, one stream read per primitive.
+         */
+        StreamReader(StreamType& Stream, SizePolicy policy = defaultSizePolicy<SizePolicy>(),
+                     std::size_t buffer_size = defaultReadBufferSize());
 
         Value getNextValue();
 
         bool getNextValue(Value& v);
 
+        /*!
+         * \brief decodes the next Object into the arena of \a doc, replacing the document it held
+         * \return false if the Object is malformed or violates the ValueSizePolicy, see getLastError()
+         */
+        bool getNextValue(Document& doc);
+
+        /*!
+         * \brief decodes the next Object from the stream as a sequence of events sent to \a handler
+         * Nothing is allocated on behalf of the decoded data; see event_handler.hpp for the Handler concept.
+         * getNextValue() is parse() with a ValueBuilder
+         * \return false if the Object is malformed or violates the ValueSizePolicy, see getLastError()
+         */
+        template<typename Handler>
+        bool parse(Handler& handler);
+
+        /*!
+         * \brief steps over the next Object without decoding it, though its structure is still checked;
+         * Objects that carry a Width hint are stepped over whole. getBytesRead() is then its size
+         * \return false if the Object is malformed or violates the ValueSizePolicy, see getLastError()
+         */
+        bool skipNextValue();
+
+        /*!
+         * \brief getNextValue(), reporting what is wrong with a malformed Object as a ParseResult
+         * \see tryParse()
+         */
+        ParseResult tryGetNextValue(Value& v);
+
+        /*!
+         * \brief parse(), except that malformed Objects are found without throwing
+         *
+         * The whole Object is checked with validate() before \a handler sees any of it, so the decode that
+         * follows can't fail, and \a handler gets no events at all for a malformed Object. The reader is then left
+         * where the Object starts, and the offset of the result is where in the Object the error is; a truncated
+         * Object is reported as ParseError::UnexpectedEnd as soon as the source runs dry.
+         *
+         * Buffered stream sources have their buffer grown to hold the Object whole, up to the
+         * ValueSizePolicy. Unbuffered ones can't be looked ahead of, so they are decoded by parse() directly.
+         * \note Width hints have to match the size of their Object here, which parse() doesn't insist on
+         */
+        template<typename Handler>
+        ParseResult tryParse(Handler& handler);
+
         StreamType& getStream() { return stream; }
 
+        //! the bytes read for the current, or last, Object; each Object starts over from 0
         std::size_t getBytesRead() const { return bytes_so_far; }
 
+        const SizePolicy& getPolicy() const { return vsz; }
+
+        /*!
+         * \brief has the keys of the Values decoded from now on interned into \a table, or not if nullptr.
+         * A key repeated across Objects is then allocated once, and shared; \a table has to outlive the reader
+         */
+        void setKeyTable(KeyTable* table)
+        {
+            key_table = table;
+            if(recycler)
+                recycler->setKeyTable(table);
+        }
+
+        /*!
+         * \brief has getNextValue(Value&) and tryGetNextValue() decode into the containers their Value already holds,
+         * rather than replacing it, or not if \a recycle is false. A receive loop decoding into the same Value
+         * then allocates nothing for messages shaped like the previous one; see ValueRecycler
+         */
+        void setRecycling(bool recycle)
+        {
+            if(not recycle)
+                recycler.reset();
+            else if(not recycler)
+                recycler.reset(new ValueRecycler(vsz, key_table));
+        }
+
         std::string getLastError() const { return last_error; }
 
-    private:
-        void extract_nextValue(Value &vref, size_t value_count, MarkerType type = MarkerType::Object, byte type_mark = 'n');
+        //! what is wrong with the last Object that failed to decode
+        ParseError getLastErrorCode() const { return last_code; }
 
-        KeyMarker extract_nextKeyMarker();
+        /*!
+         * \brief whether the source has been consumed completely
+         * \note for buffered stream sources, this may block while it pulls the next block
+         */
+        bool atEnd();
+
+    private:
+        std::pair<StringRef, bool> extract_Key();
 
         std::pair<std::size_t, bool> extract_itemCount();
         std::pair<int8_t, bool> extract_Uint8();
-        std::pair<int16_t, bool> extract_Int16();
-        std::pair<int32_t, bool> extract_Int32();
-        std::pair<int64_t, bool> extract_Int64();
-        std::pair<uint16_t, bool> extract_Uint16();
-        std::pair<uint32_t, bool> extract_Uint32();
-        std::pair<uint64_t, bool> extract_Uint64();
-        std::pair<float, bool> extract_Float32();
-        std::pair<double, bool> extract_Float64();
         std::pair<std::string, bool> extract_String();
         std::pair<Value::BinaryType, bool> extract_Binary();
-
-        void extract_count_and_Value(Value& v);
-        void extract_count_and_HomoArray(Value& v);
-        void extract_count_and_HetroArray(Value& v);
-        void extract_singleValueTo(byte marker, Value& value);
-        void extract_containerValueTo(byte marker, Value& value);
+        std::pair<StringRef, bool> extract_StringRef();
+        std::pair<ByteSpan, bool> extract_BinaryRef();
+
+        std::size_t extract_sequenceSize(std::size_t limit, const char* what);
+        ByteSpan extract_bytes(std::size_t);
+        template<typename Container>
+        void extract_bytesTo(Container&, std::size_t);
+
+        std::pair<std::size_t, bool> extract_objectCount(std::size_t& rest);
+        std::pair<std::size_t, bool> extract_hetroArrayCount();
+        std::pair<std::size_t, bool> extract_homoArrayCount(byte& type_mark);
+        ContainerFrame extract_containerHeader(byte marker, std::size_t& rest);
+        bool skip_payload(byte marker);
+        void skip_value(byte marker);
+        void skip_bytes(std::size_t);
+        void skip_hinted(std::size_t rest);
+        void begin_value();
+        ParseResult validate_next();
+
+        template<typename Handler> bool extract_singleValueTo(byte marker, Handler& handler);
+        uint64_t extract_integer(const MarkerInfo& info);
+        template<typename Handler> void extract_containerValueTo(byte marker, Handler& handler);
+        template<typename Handler> ContainerFrame open_container(byte marker, Handler& handler);
+        template<typename Handler> void close_container(MarkerType type, Handler& handler);
+        template<typename Handler> bool extract_numbersTo(const ContainerFrame& f, Handler& handler, std::true_type bulk);
+        template<typename Handler> bool extract_numbersTo(const ContainerFrame&, Handler&, std::false_type) { return false; }
+        NumericArray extract_numericArray(const ContainerFrame& f);
+        template<typename Handler> void extract_sequenceTo(byte marker, Handler& handler, std::false_type owned);
+        template<typename Handler> void extract_sequenceTo(byte marker, Handler& handler, std::true_type owned);
         void validate_container_end(MarkerType type);
 
         bool read(byte&);
         bool read(byte*, std::size_t);
+        bool read_slow(byte*, std::size_t);
+        void read_buffered(byte*, std::size_t);
+        bool fill_buffer();
+        void prefetch(std::size_t sz);
+        void update_window();
+        void attach_source(std::true_type);
+        void attach_source(std::false_type);
 
         StreamType& stream;
         std::string last_error;
+        ParseError last_code = ParseError::None;
         std::size_t bytes_so_far = 0;    //! bytes so far
-        size_t recursive_depth = 0;
-        const ValueSizePolicy vsz;
+        const SizePolicy vsz;
+        KeyTable* key_table = nullptr;
+        std::unique_ptr<ValueRecycler> recycler;    //! kept across Objects, along with its scratch state
+
+        const std::size_t buffer_size;
+        std::size_t buffer_capacity = 0;    //! grows past buffer_size to hold Objects announced by a Width hint
+        std::unique_ptr<byte[]> buffer;
+        const byte* buffer_pos = nullptr;   //! next unread byte in buffer
+        const byte* buffer_end = nullptr;   //! one past the last valid byte in buffer
+        const byte* window_end = nullptr;   //! buffer_end clamped to what vsz.max_object_size still allows
+        std::vector<byte> scratch;          //! backs the views handed out when bytes straddle buffer refills
+        std::vector<ContainerFrame> value_stack;    //! the open containers of the value being decoded
+        std::vector<ContainerFrame> skip_stack;
     };
 
-    template<typename StreamType>
-    StreamReader<StreamType>::StreamReader(StreamType& Stream, ValueSizePolicy policy)
-        : stream(Stream), vsz(policy)
-    {}
+    //! A StreamReader decoding straight out of memory, no iostream involved
+    using BufferReader = StreamReader<ByteSpan>;
 
+    template<typename StreamType, typename SizePolicy>
+    StreamReader<StreamType, SizePolicy>::StreamReader(StreamType& Stream, SizePolicy policy, std::size_t bufferSize)
+        : stream(Stream), vsz(policy), buffer_size(bufferSize)
+    {
+        attach_source(std::integral_constant<bool, stream_source<StreamType>::contiguous>());
+        update_window();
+        value_stack.reserve(std::min<std::size_t>(vsz.max_value_depth, 64));
+    }
 
-    template<typename StreamType>
-    Value StreamReader<StreamType>::getNextValue()
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::attach_source(std::true_type)
+    {
+        buffer_pos = stream_source<StreamType>::data(stream);
+        buffer_end = buffer_pos + stream_source<StreamType>::size(stream);
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::attach_source(std::false_type)
+    {
+        if(buffer_size > 0)
+        {
+            buffer.reset(new byte[buffer_size]);
+            buffer_capacity = buffer_size;
+        }
+    }
+
+
+    template<typename StreamType, typename SizePolicy>
+    Value StreamReader<StreamType, SizePolicy>::getNextValue()
     {
         Value v;        getNextValue(v);        return v;
     }
 
-    template<typename StreamType>
-    bool StreamReader<StreamType>::getNextValue(Value& v)
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::getNextValue(Value& v)
+    {
+        if(recycler)
+        {
+            recycler->refill(v);
+            return parse(*recycler);
+        }
+        ValueBuilder builder(v, vsz, key_table);
+        return parse(builder);
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::getNextValue(Document& doc)
+    {
+        DocumentBuilder builder(doc);
+        return parse(builder);
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    bool StreamReader<StreamType, SizePolicy>::parse(Handler& handler)
     {
         bool good = false;
 
         try
         {
-            bytes_so_far = 0;
-            recursive_depth = 0;
+            begin_value();
             byte b;
             read(b);
             if(not isObjectStart(b))
-                throw parsing_exception("Stream does not contain a valid Object - ObjectStartMarker");
-            extract_count_and_Value(v);
+                throw parsing_exception(ParseError::NotAnObject);
+            extract_containerValueTo(b, handler);
             good = true;
         }
         catch(parsing_exception& pexecpt)
         {
             last_error = pexecpt.what();
+            last_code = pexecpt.code();
         }
         return good;
     }
 
-    template<typename StreamType>
-    bool StreamReader<StreamType>::read(byte& b)
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::skipNextValue()
     {
-        read(&b, 1);
-        return true;
+        try
+        {
+            begin_value();
+            byte b;
+            read(b);
+            if(not isObjectStart(b))
+                throw parsing_exception(ParseError::NotAnObject);
+            skip_value(b);
+            return true;
+        }
+        catch(parsing_exception& pexecpt)
+        {
+            last_error = pexecpt.what();
+            last_code = pexecpt.code();
+        }
+        return false;
     }
 
-    template<typename StreamType>
-    bool StreamReader<StreamType>::read(byte* b, std::size_t sz)
+    template<typename StreamType, typename SizePolicy>
+    ParseResult StreamReader<StreamType, SizePolicy>::tryGetNextValue(Value& v)
     {
-        using std::to_string;
-        using std::string;
+        if(recycler)
+        {
+            recycler->refill(v);
+            return tryParse(*recycler);
+        }
+        ValueBuilder builder(v, vsz, key_table);
+        return tryParse(builder);
+    }
 
-        if(bytes_so_far + sz > vsz.max_object_size)
-            throw policy_violation("Maximum Object size read at: " + to_string(bytes_so_far));
-        stream.read(to_cbyte(b), sz);
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    ParseResult StreamReader<StreamType, SizePolicy>::tryParse(Handler& handler)
+    {
+        begin_value();
+        const ParseResult checked = validate_next();
+        if(not checked)
+        {
+            last_error = checked.message();
+            last_code = checked.code;
+            return checked;
+        }
+        if(parse(handler))
+            return ParseResult{ParseError::None, bytes_so_far};
+        return ParseResult{last_code, bytes_so_far};
+    }
+
+    /*!
+     * validates the Object at the read position, pulling it into the buffer whole first.
+     * The buffer grows geometrically, for as long as the Object seems truncated
+     * \return ParseError::None for unbuffered stream sources, which can't be checked ahead
+     */
+    template<typename StreamType, typename SizePolicy>
+    ParseResult StreamReader<StreamType, SizePolicy>::validate_next()
+    {
+        if(not buffer and not stream_source<StreamType>::contiguous)
+            return ParseResult{ParseError::None, 0};
+
+        for(;;)
+        {
+            const std::size_t buffered = buffer_end - buffer_pos;
+            const ParseResult checked = validate(ByteSpan(buffer_pos, buffered), vsz);
+            if(checked.code != ParseError::UnexpectedEnd or not buffer)
+                return checked;
+            if(buffered >= vsz.max_object_size)
+                return ParseResult{ParseError::ObjectTooLarge, vsz.max_object_size};
+
+            prefetch(std::min(std::max(2 * buffered, buffer_size), vsz.max_object_size));
+            if(static_cast<std::size_t>(buffer_end - buffer_pos) == buffered)
+                return checked;
+        }
+    }
+
+    //! resets the per-Object accounting the ValueSizePolicy is enforced against
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::begin_value()
+    {
+        bytes_so_far = 0;
+        value_stack.clear();
+        update_window();
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::atEnd()
+    {
+        if(buffer_pos != buffer_end)
+            return false;
+        if(buffer)
+        {
+            const bool more = fill_buffer();
+            update_window();
+            return not more;
+        }
+        return stream_source<StreamType>::at_end(stream);
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    inline bool StreamReader<StreamType, SizePolicy>::read(byte& b)
+    {
+        if(buffer_pos == window_end)
+            return read_slow(&b, 1);
+        b = *buffer_pos++;
+        ++bytes_so_far;
+        return true;
+    }
+
+    //! The window only ever covers bytes that are both buffered and allowed by the size policy,
+    //! so the common case costs a single comparison
+    template<typename StreamType, typename SizePolicy>
+    inline bool StreamReader<StreamType, SizePolicy>::read(byte* b, std::size_t sz)
+    {
+        if(sz > static_cast<std::size_t>(window_end - buffer_pos))
+            return read_slow(b, sz);
+        std::memcpy(b, buffer_pos, sz);
+        buffer_pos += sz;
         bytes_so_far += sz;
         return true;
     }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::extract_nextValue(Value& vref, size_t value_count, MarkerType type, byte type_mark)
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::read_slow(byte* b, std::size_t sz)
     {
-        if(++recursive_depth > vsz.max_value_depth)
-            throw parsing_exception("Maximum Parsing depth Exceeded!");
+        using std::to_string;
 
-        decltype(KeyMarker::marker) marker;
-        std::string key;
-        KeyMarker km;
-        while (value_count > 0) {
+        if(bytes_so_far + sz > vsz.max_object_size)
+            throw policy_violation("Maximum Object size read at: " + to_string(bytes_so_far), ParseError::ObjectTooLarge);
 
-            Value value;
-            switch (type) {
-            case MarkerType::Object:
-                km = extract_nextKeyMarker();
-                marker = km.marker;
-                key = std::string(to_cbyte(km.value), to_cbyte(km.value) + size_t(km.len));
-                break;
-            case MarkerType::HetroArray:
-                marker = extract_Uint8().first;
-                break;
-            case MarkerType::HomoArray:
-                marker = type_mark;
-            default:
-                break;
-            }
+        if(buffer)
+            read_buffered(b, sz);
+        else if(not stream_source<StreamType>::read(stream, b, sz))
+            throw parsing_exception(ParseError::UnexpectedEnd);
 
-            extract_singleValueTo(marker, value);
-            extract_containerValueTo(marker, value);
+        bytes_so_far += sz;
+        update_window();
+        return true;
+    }
 
-            switch (type) {
-            case MarkerType::Object:
-                vref[key] = std::move(value);
-                break;
-            case MarkerType::HetroArray:
-            case MarkerType::HomoArray:
-                vref.push_back( std::move(value) );
-                break;
+    //! slow path of read(): drains the buffer, then refills it or bypasses it for large reads
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::read_buffered(byte* b, std::size_t sz)
+    {
+        while(sz > 0)
+        {
+            std::size_t available = buffer_end - buffer_pos;
+            if(available == 0)
+            {
+                if(sz >= buffer_size)
+                {
+                    const std::size_t got = stream_source<StreamType>::read_some(stream, b, sz);
+                    if(got == 0)
+                        throw parsing_exception(ParseError::UnexpectedEnd);
+                    b += got;
+                    sz -= got;
+                    continue;
+                }
+                if(not fill_buffer())
+                    throw parsing_exception(ParseError::UnexpectedEnd);
+                available = buffer_end - buffer_pos;
             }
-            --value_count;
+
+            const std::size_t chunk = std::min(available, sz);
+            std::memcpy(b, buffer_pos, chunk);
+            buffer_pos += chunk;
+            b += chunk;
+            sz -= chunk;
         }
-        validate_container_end(type);
-        --recursive_depth;
     }
 
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::fill_buffer()
+    {
+        const std::size_t got = stream_source<StreamType>::read_some(stream, buffer.get(), buffer_size);
+        buffer_pos = buffer.get();
+        buffer_end = buffer_pos + got;
+        return got > 0;
+    }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::extract_singleValueTo(byte marker, Value& value)
+    /*!
+     * makes the next \a sz bytes of a buffered stream source available in the buffer at once,
+     * growing it if needed, so they decode without refills or copies into scratch.
+     * Stops short at the end of the stream, or if \a sz is beyond the ValueSizePolicy
+     */
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::prefetch(std::size_t sz)
     {
-        if(isNull(marker))
-        {
-            value = Value();
-        }
-        else if(isTrue(marker))
-        {
-            value = true;
-        }
-        else if(isFalse(marker))
-        {
-            value = false;
-        }
-        else if(isChar(marker))
-        {
-            uint8_t extracted(extract_Uint8().first);
-            char val(extracted);
-            value = val;
-        }
-        else if(isUint8(marker))
-        {
-            uint8_t extracted(extract_Uint8().first);
-            unsigned long long val(extracted);
-            value = val;
-        }
-        else if(isInt8(marker))
-        {
-            int8_t extracted(extract_Uint8().first);
-            long long val(extracted);
-            value = val;
-        }
-        else if(isInt16(marker))
-        {
-            int16_t extracted(extract_Int16().first);
-            int val(extracted);
-            value = val;
-        }
-        else if(isInt32(marker))
-        {
-            int32_t extracted(extract_Int32().first);
-            int val(extracted);
-            value = val;
-        }
-        else if(isInt64(marker))
-        {
-            int64_t extracted(extract_Int64().first);
-            long long val(extracted);
-            value = val;
-        }
-        else if(isUint16(marker))
+        const std::size_t buffered = buffer_end - buffer_pos;
+        if(not buffer or sz <= buffered or sz > vsz.max_object_size - bytes_so_far)
+            return;
+
+        if(sz > buffer_capacity)
         {
-            uint16_t extracted(extract_Uint16().first);
-            unsigned long long val(extracted);
-            value = val;
+            std::unique_ptr<byte[]> grown(new byte[sz]);
+            std::memcpy(grown.get(), buffer_pos, buffered);
+            buffer = std::move(grown);
+            buffer_capacity = sz;
         }
-        else if(isUint32(marker))
+        else
+            std::memmove(buffer.get(), buffer_pos, buffered);
+
+        buffer_pos = buffer.get();
+        buffer_end = buffer_pos + buffered;
+        while(buffer_end < buffer_pos + sz)
         {
-            uint32_t extracted(extract_Uint32().first);
-            unsigned long long val(extracted);
-            value = val;
+            const std::size_t got = stream_source<StreamType>::read_some(stream, buffer.get() + (buffer_end - buffer_pos), sz - (buffer_end - buffer_pos));
+            if(got == 0)
+                break;
+            buffer_end += got;
         }
-        else if(isUint64(marker))
+        update_window();
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    inline void StreamReader<StreamType, SizePolicy>::update_window()
+    {
+        const std::size_t budget = vsz.max_object_size - bytes_so_far;
+        const std::size_t buffered = buffer_end - buffer_pos;
+        window_end = buffered > budget ? buffer_pos + budget : buffer_end;
+    }
+
+    //! emits the scalar introduced by \a marker, returns false if \a marker does not introduce a scalar
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    bool StreamReader<StreamType, SizePolicy>::extract_singleValueTo(byte marker, Handler& handler)
+    {
+        const MarkerInfo& info = markerInfo(marker);
+        switch (info.kind) {
+        case MarkerKind::Null:
+            handler.null();
+            break;
+        case MarkerKind::True:
+            handler.boolean(true);
+            break;
+        case MarkerKind::False:
+            handler.boolean(false);
+            break;
+        case MarkerKind::Char:
+            handler.character(static_cast<char>(extract_Uint8().first));
+            break;
+        case MarkerKind::SignedInt:
+            handler.int64(static_cast<long long>(extract_integer(info)));
+            break;
+        case MarkerKind::UnsignedInt:
+            handler.uint64(extract_integer(info));
+            break;
+        case MarkerKind::Float:
         {
-            uint64_t extracted(extract_Uint64().first);
-            unsigned long long val(extracted);
-            value = val;
+            const uint64_t bits = extract_integer(info);
+            const uint32_t bits32 = static_cast<uint32_t>(bits);
+            float f;
+            double d;
+            std::memcpy(&f, &bits32, 4);
+            std::memcpy(&d, &bits, 8);
+            handler.float64(info.width == 4 ? f : d);
+            break;
         }
-        else if(isFloat32(marker))
+        case MarkerKind::String:
+        case MarkerKind::Binary:
         {
-            float extracted(extract_Float32().first);
-            double val(extracted);
-            value = val;
+            using owned = std::integral_constant<bool, handler_traits<Handler>::owns_sequences>;
+            extract_sequenceTo(marker, handler, owned());
+            break;
         }
-        else if(isFloat64(marker))
-        {
-            double extracted(extract_Float64().first);
-            double val(extracted);
-            value = val;
+        default:
+            return false;
         }
-        else if(isString(marker))
+        return true;
+    }
+
+    /*!
+     * reads the big endian integer payload described by \a info. Whenever 8 bytes are buffered,
+     * every width shares one load, so decoding doesn't branch on the width
+     * \return its value, sign extended to 64 bits for signed markers
+     */
+    template<typename StreamType, typename SizePolicy>
+    inline uint64_t StreamReader<StreamType, SizePolicy>::extract_integer(const MarkerInfo& info)
+    {
+        byte b[8] = {};
+        const byte* src = buffer_pos;
+        if(window_end - buffer_pos >= 8)
         {
-            value = extract_String().first;
+            buffer_pos += info.width;
+            bytes_so_far += info.width;
         }
-        else if(isBinary(marker))
+        else
         {
-            value = extract_Binary().first;
+            read(b, info.width);
+            src = b;
         }
+
+        uint64_t v;
+        std::memcpy(&v, src, 8);
+        v = fromBigEndian64(v);     //the payload now occupies the most significant bytes
+        const unsigned shift = 64 - 8 * info.width;
+        return info.is_signed ? static_cast<uint64_t>(static_cast<int64_t>(v) >> shift) : v >> shift;
     }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::extract_containerValueTo(byte marker, Value &value)
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    void StreamReader<StreamType, SizePolicy>::extract_sequenceTo(byte marker, Handler& handler, std::false_type)
     {
-        if(isObjectStart(marker))
-        {
-            extract_count_and_Value(value);
-        }
+        if(isString(marker))
+            handler.string(extract_StringRef().first);
+        else
+            handler.binary(extract_BinaryRef().first);
+    }
 
-        else if(isHomoArrayStart(marker))
-        {
-            extract_count_and_HomoArray(value);
-        }
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    void StreamReader<StreamType, SizePolicy>::extract_sequenceTo(byte marker, Handler& handler, std::true_type)
+    {
+        if(isString(marker))
+            handler.string(extract_String().first);
+        else
+            handler.binary(extract_Binary().first);
+    }
 
-        else if(isHetroArrayStart(marker))
+    /*!
+     * emits the container introduced by \a marker, everything nested in it included.
+     * Rather than recursing per nesting level, the container being read is kept in a local
+     * frame and its ancestors wait on value_stack. So the depth a document may reach is only
+     * bounded by ValueSizePolicy::max_value_depth, a small heap frame per level.
+     */
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    void StreamReader<StreamType, SizePolicy>::extract_containerValueTo(byte marker, Handler& handler)
+    {
+        const std::size_t base = value_stack.size();
+        ContainerFrame f = open_container(marker, handler);
+        if(f.end_consumed)
+            return;
+        if(vsz.max_value_depth == 0)
+            throw parsing_exception(ParseError::TooDeep);
+
+        using bulk = std::integral_constant<bool, handler_traits<Handler>::bulk_numbers>;
+        if(extract_numbersTo(f, handler, bulk()))
+            return;
+
+        for(;;)
         {
-            extract_count_and_HetroArray(value);
+            if(f.remaining == 0)
+            {
+                validate_container_end(f.type);
+                close_container(f.type, handler);
+                if(value_stack.size() == base)
+                    return;
+                f = value_stack.back();
+                value_stack.pop_back();
+                continue;
+            }
+
+            --f.remaining;
+            marker = f.type_mark;
+            switch (f.type) {
+            case MarkerType::Object:
+                handler.key(extract_Key().first);
+                read(marker);
+                break;
+            case MarkerType::HetroArray:
+                read(marker);
+                break;
+            case MarkerType::HomoArray:
+            default:
+                break;
+            }
+
+            if(extract_singleValueTo(marker, handler))
+                continue;
+
+            const ContainerFrame child = open_container(marker, handler);
+            if(not child.end_consumed)
+            {
+                //child nests in f, which nests in everything waiting on value_stack
+                if(value_stack.size() - base + 2 > vsz.max_value_depth)
+                    throw parsing_exception(ParseError::TooDeep);
+                if(extract_numbersTo(child, handler, bulk()))
+                    continue;
+                value_stack.push_back(f);
+                f = child;
+            }
         }
     }
 
+    /*!
+     * reads the header of a container and emits its start. Empty containers are closed right away,
+     * they don't count towards ValueSizePolicy::max_value_depth
+     */
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    ContainerFrame StreamReader<StreamType, SizePolicy>::open_container(byte marker, Handler& handler)
+    {
+        std::size_t rest;
+        const ContainerFrame f = extract_containerHeader(marker, rest);
+        if(rest > 0)
+            prefetch(rest);
+        if(f.type == MarkerType::Object)
+            handler.startObject(f.remaining);
+        else
+            handler.startArray(f.remaining);
+
+        if(f.end_consumed)
+            close_container(f.type, handler);
+        return f;
+    }
 
-    template<typename StreamType>
-    KeyMarker StreamReader<StreamType>::extract_nextKeyMarker()
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    void StreamReader<StreamType, SizePolicy>::close_container(MarkerType type, Handler& handler)
     {
-        KeyMarker km;
-        read(km.len);
-        read(km.value, std::size_t(km.len));
-        read(km.marker);
-        return km;
+        if(type == MarkerType::Object)
+            handler.endObject();
+        else
+            handler.endArray();
     }
 
-    template<typename StreamType>
-    std::pair<std::size_t, bool> StreamReader<StreamType>::extract_itemCount()
+    /*!
+     * if \a f is a homogenous Array of numbers, emits all its items at once through Handler::numbers(),
+     * then closes it
+     * \return false, having read nothing, for every other container
+     */
+    template<typename StreamType, typename SizePolicy>
+    template<typename Handler>
+    bool StreamReader<StreamType, SizePolicy>::extract_numbersTo(const ContainerFrame& f, Handler& handler, std::true_type)
+    {
+        if(f.type != MarkerType::HomoArray or not isBulkNumeric(f.type_mark))
+            return false;
+        handler.numbers(extract_numericArray(f));
+        validate_container_end(f.type);
+        close_container(f.type, handler);
+        return true;
+    }
+
+    //! reads all the items of the homogenous numeric Array \a f with a single read
+    template<typename StreamType, typename SizePolicy>
+    NumericArray StreamReader<StreamType, SizePolicy>::extract_numericArray(const ContainerFrame& f)
+    {
+        const std::size_t width = markerInfo(f.type_mark).width;
+        if(f.remaining > vsz.max_object_size / width)
+            throw policy_violation("Maximum Object size read at: " + std::to_string(bytes_so_far), ParseError::ObjectTooLarge);
+        return NumericArray(f.type_mark, extract_bytes(f.remaining * width));
+    }
+
+
+    //! Keys are a single length byte followed by at most 255 bytes
+    template<typename StreamType, typename SizePolicy>
+    std::pair<StringRef, bool> StreamReader<StreamType, SizePolicy>::extract_Key()
+    {
+        byte len;
+        read(len);
+        const ByteSpan b = extract_bytes(len);
+        return std::make_pair(StringRef(to_cbyte(b.data()), b.size()), true);
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    std::pair<std::size_t, bool> StreamReader<StreamType, SizePolicy>::extract_itemCount()
     {
         byte b[4];
         read(b[0]);
@@ -333,185 +923,353 @@ namespace timl {
         return std::make_pair(std::size_t(b[0]), false);
     }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::extract_count_and_Value(Value& v)
+    /*!
+     * reads what follows an ObjectStart marker up to the first key.
+     * An Object may open with a Width hint, <tt>{ W width count ...</tt>, where \e width is the number of
+     * bytes that follow it up to and including the ObjectEnd marker.
+     * \param rest set to the bytes left in the Object after what was read here, its ObjectEnd marker
+     * included; 0 if there was no Width hint
+     * \return the item count, or \e false if the Object turned out empty; its end marker is then consumed
+     */
+    template<typename StreamType, typename SizePolicy>
+    std::pair<std::size_t, bool> StreamReader<StreamType, SizePolicy>::extract_objectCount(std::size_t& rest)
     {
+        rest = 0;
         auto icount = extract_itemCount();
-        if(not icount.second)
+        if(not icount.second and isWidthMarker(static_cast<byte>(icount.first)))
         {
-            if(isWidthMarker( static_cast<byte>(icount.first)))
-            {
-                auto wsize = extract_itemCount();
-                if(not wsize.second)
-                    throw parsing_exception("Ill formed object!");
-
-                //! \todo TODO: Add this up
-                //readHint(wsize.first);
-
-                icount = extract_itemCount();
-                if(not icount.second)
-                    icount.first = 0;
-            }
-            else
+            auto wsize = extract_itemCount();
+            if(not wsize.second)
+                throw parsing_exception(ParseError::IllFormedHeader);
+
+            const std::size_t start = bytes_so_far;
+            icount = extract_itemCount();
+            //the width has to cover at least the item count and the ObjectEnd marker
+            const std::size_t consumed = bytes_so_far - start;
+            if(icount.second)
             {
-                byte marker = static_cast<byte>(icount.first);
-                if(not isObjectEnd(marker))
-                    throw parsing_exception("empty Object is ill-formed");
-                return;
+                if(wsize.first <= consumed)
+                    throw parsing_exception(ParseError::IllFormedHeader);
+                rest = wsize.first - consumed;
             }
+            else if(wsize.first != consumed)
+                throw parsing_exception(ParseError::IllFormedHeader);
         }
 
-        extract_nextValue(v, icount.first, MarkerType::Object);
+        if(not icount.second)
+        {
+            byte marker = static_cast<byte>(icount.first);
+            if(not isObjectEnd(marker))
+                throw parsing_exception("empty Object is ill-formed", ParseError::IllFormedHeader);
+            return std::make_pair(0, false);
+        }
+        return std::make_pair(icount.first, true);
     }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::extract_count_and_HomoArray(Value& v)
+    //! \see extract_objectCount()
+    template<typename StreamType, typename SizePolicy>
+    std::pair<std::size_t, bool> StreamReader<StreamType, SizePolicy>::extract_hetroArrayCount()
     {
-        byte type_mark = static_cast<byte>(extract_Uint8().first);
         auto icount = extract_itemCount();
         if(icount.second)
-            extract_nextValue(v, icount.first, MarkerType::HomoArray, type_mark);
+            return icount;
 
         byte marker = static_cast<byte>(icount.first);
-        if(not isHomoArrayEnd(marker))
-            throw parsing_exception("empty HomogenousArray is ill-formed");
+        if(not isHetroArrayEnd(marker))
+            throw parsing_exception("empty HetrogenousArray is ill-formed", ParseError::IllFormedHeader);
+        return std::make_pair(0, false);
     }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::extract_count_and_HetroArray(Value &v)
+    //! \see extract_objectCount()
+    template<typename StreamType, typename SizePolicy>
+    std::pair<std::size_t, bool> StreamReader<StreamType, SizePolicy>::extract_homoArrayCount(byte& type_mark)
     {
+        type_mark = static_cast<byte>(extract_Uint8().first);
         auto icount = extract_itemCount();
-        if(icount.second )
-            return extract_nextValue(v, icount.first, MarkerType::HetroArray);
+        if(icount.second)
+            return icount;
 
         byte marker = static_cast<byte>(icount.first);
-        if(not isHetroArrayEnd(marker))
-            throw parsing_exception("empty HetrogenousArray is ill-formed");
+        if(not isHomoArrayEnd(marker))
+            throw parsing_exception("empty HomogenousArray is ill-formed", ParseError::IllFormedHeader);
+        return std::make_pair(0, false);
     }
 
-    template<typename StreamType>
-    void StreamReader<StreamType>::validate_container_end(MarkerType type)
+    /*!
+     * reads the header of the container introduced by \a marker
+     * \param rest the byte count still ahead in the container if it announced one with a Width hint, otherwise 0
+     */
+    template<typename StreamType, typename SizePolicy>
+    ContainerFrame StreamReader<StreamType, SizePolicy>::extract_containerHeader(byte marker, std::size_t& rest)
     {
-        byte b;
-        read(b);
-        switch (type) {
-        case MarkerType::Object:
-            if(not isObjectEnd(b))
-                throw parsing_exception("Object is incomplete otherwise corrupt");
+        ContainerFrame f{MarkerType::Object, 'n', false, 0};
+        std::pair<std::size_t, bool> icount;
+        rest = 0;
+        switch (markerInfo(marker).kind) {
+        case MarkerKind::Object:
+            icount = extract_objectCount(rest);
             break;
-        case MarkerType::HetroArray:
-            if(not isHetroArrayEnd(b))
-                throw parsing_exception("Object is incomplete otherwise corrupt");
+        case MarkerKind::HetroArray:
+            f.type = MarkerType::HetroArray;
+            icount = extract_hetroArrayCount();
             break;
-        case MarkerType::HomoArray:
-            if(not isHomoArrayEnd(b))
-                throw parsing_exception("Object is incomplete otherwise corrupt");
-        default:
+        case MarkerKind::HomoArray:
+            f.type = MarkerType::HomoArray;
+            icount = extract_homoArrayCount(f.type_mark);
             break;
+        default:
+            throw parsing_exception(ParseError::UnknownMarker);
         }
+
+        f.remaining = icount.first;
+        f.end_consumed = not icount.second;
+        return f;
     }
 
+    //! steps over the value introduced by \a marker, containers included, without decoding it
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::skip_value(byte marker)
+    {
+        if(skip_payload(marker))
+            return;
 
+        std::size_t rest;
+        const ContainerFrame root = extract_containerHeader(marker, rest);
+        if(rest > 0)
+        {
+            skip_hinted(rest);
+            return;
+        }
 
-    template<typename StreamType>
-    std::pair<int16_t, bool> StreamReader<StreamType>::extract_Int16()
-    {
-        byte b[2];
-        read(b, 2);
-        return std::make_pair(fromBigEndian16(b), true);
-    }
+        skip_stack.clear();
+        skip_stack.push_back(root);
+        while(not skip_stack.empty())
+        {
+            ContainerFrame& f = skip_stack.back();
+            if(f.remaining == 0)
+            {
+                if(not f.end_consumed)
+                    validate_container_end(f.type);
+                skip_stack.pop_back();
+                continue;
+            }
 
-    template<typename StreamType>
-    std::pair<int32_t, bool> StreamReader<StreamType>::extract_Int32()
-    {
-        byte b[4];
-        read(b, 4);
-        return std::make_pair(fromBigEndian32(b), true);
+            --f.remaining;
+            byte m = f.type_mark;
+            if(f.type == MarkerType::Object)
+            {
+                byte len;
+                read(len);
+                skip_bytes(len);
+                read(m);
+            }
+            else if(f.type == MarkerType::HetroArray)
+                read(m);
+
+            if(not skip_payload(m))
+            {
+                if(skip_stack.size() >= vsz.max_value_depth)
+                    throw parsing_exception(ParseError::TooDeep);
+                const ContainerFrame child = extract_containerHeader(m, rest);
+                if(rest > 0)
+                    skip_hinted(rest);
+                else
+                    skip_stack.push_back(child);
+            }
+        }
     }
 
-    template<typename StreamType>
-    std::pair<int64_t, bool> StreamReader<StreamType>::extract_Int64()
+    /*!
+     * steps over the payload of the scalar introduced by \a marker without decoding it
+     * \return false if \a marker does not introduce a scalar
+     */
+    template<typename StreamType, typename SizePolicy>
+    bool StreamReader<StreamType, SizePolicy>::skip_payload(byte marker)
     {
-        byte b[8];
-        read(b, 8);
-        return std::make_pair(fromBigEndian64(b), true);
+        const MarkerInfo& info = markerInfo(marker);
+        switch (info.kind) {
+        case MarkerKind::String:
+            skip_bytes(extract_sequenceSize(vsz.max_string_size, "String"));
+            return true;
+        case MarkerKind::Binary:
+            skip_bytes(extract_sequenceSize(vsz.max_binary_size, "Binary"));
+            return true;
+        case MarkerKind::Invalid:
+        case MarkerKind::Object:
+        case MarkerKind::HetroArray:
+        case MarkerKind::HomoArray:
+            return false;
+        default:
+            skip_bytes(info.width);
+            return true;
+        }
     }
 
-    template<typename StreamType>
-    std::pair<uint16_t, bool> StreamReader<StreamType>::extract_Uint16()
+    //! steps over the rest of an Object whose header carried a Width hint, without looking at its items
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::skip_hinted(std::size_t rest)
     {
-        byte b[2];
-        read(b, 2);
-        return std::make_pair(fromBigEndian16(b), true);
+        skip_bytes(rest - 1);
+        validate_container_end(MarkerType::Object);
     }
 
-    template<typename StreamType>
-    std::pair<uint32_t, bool> StreamReader<StreamType>::extract_Uint32()
+    //! consumes \a sz bytes without copying them anywhere
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::skip_bytes(std::size_t sz)
     {
-        byte b[4];
-        read(b, 4);
-        return std::make_pair(fromBigEndian32(b), true);
+        if(sz <= static_cast<std::size_t>(window_end - buffer_pos))
+        {
+            buffer_pos += sz;
+            bytes_so_far += sz;
+            return;
+        }
+
+        if(bytes_so_far + sz > vsz.max_object_size)
+            throw policy_violation("Maximum Object size read at: " + std::to_string(bytes_so_far), ParseError::ObjectTooLarge);
+        if(not buffer)
+        {
+            byte b[256];
+            for(std::size_t left = sz; left > 0; )
+            {
+                const std::size_t chunk = std::min(left, sizeof(b));
+                read(b, chunk);
+                left -= chunk;
+            }
+            return;
+        }
+
+        std::size_t left = sz;
+        while(left > 0)
+        {
+            if(buffer_pos == buffer_end and not fill_buffer())
+                throw parsing_exception(ParseError::UnexpectedEnd);
+            const std::size_t chunk = std::min<std::size_t>(left, buffer_end - buffer_pos);
+            buffer_pos += chunk;
+            left -= chunk;
+        }
+        bytes_so_far += sz;
+        update_window();
     }
 
-    template<typename StreamType>
-    std::pair<uint64_t, bool> StreamReader<StreamType>::extract_Uint64()
+    template<typename StreamType, typename SizePolicy>
+    void StreamReader<StreamType, SizePolicy>::validate_container_end(MarkerType type)
     {
-        byte b[8];
-        read(b, 8);
-        return std::make_pair(fromBigEndian64(b), true);
+        byte b;
+        read(b);
+        switch (type) {
+        case MarkerType::Object:
+            if(not isObjectEnd(b))
+                throw parsing_exception(ParseError::MissingEnd);
+            break;
+        case MarkerType::HetroArray:
+            if(not isHetroArrayEnd(b))
+                throw parsing_exception(ParseError::MissingEnd);
+            break;
+        case MarkerType::HomoArray:
+            if(not isHomoArrayEnd(b))
+                throw parsing_exception(ParseError::MissingEnd);
+        default:
+            break;
+        }
     }
 
-    template<typename StreamType>
-    std::pair<int8_t, bool> StreamReader<StreamType>::extract_Uint8()
+
+
+    template<typename StreamType, typename SizePolicy>
+    std::pair<int8_t, bool> StreamReader<StreamType, SizePolicy>::extract_Uint8()
     {
         byte b;
         read(b);
         return std::make_pair(fromBigEndian8(&b), true);
     }
 
-    template<typename StreamType>
-    std::pair<float, bool> StreamReader<StreamType>::extract_Float32()
+    //! reads the item count of a String or Binary, enforcing the given policy \a limit
+    template<typename StreamType, typename SizePolicy>
+    std::size_t StreamReader<StreamType, SizePolicy>::extract_sequenceSize(std::size_t limit, const char* what)
     {
-        byte b[4];
-        read(b, 4);
-        return std::make_pair(fromBigEndianFloat32(b), true);
+        using std::to_string;
+
+        auto icount = extract_itemCount();
+        if(not icount.second)
+            throw parsing_exception(ParseError::InvalidCount);
+        if(icount.first > limit)
+            throw policy_violation(std::string("Maximum ") + what + " size exceeded at: " + to_string(bytes_so_far),
+                                   what[0] == 'S' ? ParseError::StringTooLarge : ParseError::BinaryTooLarge);
+        return icount.first;
     }
 
-    template<typename StreamType>
-    std::pair<double, bool> StreamReader<StreamType>::extract_Float64()
+    /*!
+     * Hands out the next \a sz bytes without copying them whenever they are already in the read window,
+     * which is always the case for contiguous sources. Otherwise, they are copied into \a scratch.
+     * Either way, the view is only good until the next read from a stream source
+     */
+    template<typename StreamType, typename SizePolicy>
+    ByteSpan StreamReader<StreamType, SizePolicy>::extract_bytes(std::size_t sz)
     {
-        byte b[8];
-        read(b, 8);
-        return std::make_pair(fromBigEndianFloat64(b), true);
+        if(sz <= static_cast<std::size_t>(window_end - buffer_pos))
+        {
+            ByteSpan rtn(buffer_pos, sz);
+            buffer_pos += sz;
+            bytes_so_far += sz;
+            return rtn;
+        }
+
+        if(bytes_so_far + sz > vsz.max_object_size)     //don't let a bogus size allocate scratch
+            throw policy_violation("Maximum Object size read at: " + std::to_string(bytes_so_far), ParseError::ObjectTooLarge);
+        scratch.resize(sz);
+        read(scratch.data(), sz);
+        return ByteSpan(scratch.data(), sz);
     }
 
-    template<typename StreamType>
-    std::pair<std::string, bool> StreamReader<StreamType>::extract_String()
+    //! copies the next \a sz bytes into \a c; one allocation, one copy
+    template<typename StreamType, typename SizePolicy>
+    template<typename Container>
+    void StreamReader<StreamType, SizePolicy>::extract_bytesTo(Container& c, std::size_t sz)
     {
-        auto icount = extract_itemCount();
-        if(not icount.second)
-            throw parsing_exception("Invalid count token encounted!");
+        using T = typename Container::value_type;
+
+        if(sz <= static_cast<std::size_t>(window_end - buffer_pos))
+        {
+            const T* first = reinterpret_cast<const T*>(buffer_pos);
+            c.assign(first, first + sz);
+            buffer_pos += sz;
+            bytes_so_far += sz;
+            return;
+        }
 
-        //byte* b = new byte[icount.first];
-        std::unique_ptr<byte[]> b(new byte[icount.first]);
-        read(b.get(), icount.first);
+        if(bytes_so_far + sz > vsz.max_object_size)
+            throw policy_violation("Maximum Object size read at: " + std::to_string(bytes_so_far), ParseError::ObjectTooLarge);
+        c.resize(sz);
+        read(reinterpret_cast<byte*>(&c[0]), sz);
+    }
 
-        std::string rtn(to_cbyte(b.get()), to_cbyte(b.get()) + icount.first);
-        return std::make_pair(rtn, true);
+    template<typename StreamType, typename SizePolicy>
+    std::pair<std::string, bool> StreamReader<StreamType, SizePolicy>::extract_String()
+    {
+        std::string rtn;
+        extract_bytesTo(rtn, extract_sequenceSize(vsz.max_string_size, "String"));
+        return std::make_pair(std::move(rtn), true);
     }
 
-    template<typename StreamType>
-    std::pair<Value::BinaryType, bool> StreamReader<StreamType>::extract_Binary()
+    template<typename StreamType, typename SizePolicy>
+    std::pair<Value::BinaryType, bool> StreamReader<StreamType, SizePolicy>::extract_Binary()
     {
-        auto icount = extract_itemCount();
-        if(not icount.second)
-            throw parsing_exception("Invalid count token encounted!");
+        Value::BinaryType rtn;
+        extract_bytesTo(rtn, extract_sequenceSize(vsz.max_binary_size, "Binary"));
+        return std::make_pair(std::move(rtn), true);
+    }
 
-        std::unique_ptr<byte[]> b(new byte[icount.first]);
-        read(b.get(), icount.first);
+    template<typename StreamType, typename SizePolicy>
+    std::pair<StringRef, bool> StreamReader<StreamType, SizePolicy>::extract_StringRef()
+    {
+        const ByteSpan b = extract_bytes(extract_sequenceSize(vsz.max_string_size, "String"));
+        return std::make_pair(StringRef(to_cbyte(b.data()), b.size()), true);
+    }
 
-        Value::BinaryType rtn(to_cbyte(b.get()), to_cbyte(b.get()) + icount.first);
-        return std::make_pair(rtn, true);
+    template<typename StreamType, typename SizePolicy>
+    std::pair<ByteSpan, bool> StreamReader<StreamType, SizePolicy>::extract_BinaryRef()
+    {
+        return std::make_pair(extract_bytes(extract_sequenceSize(vsz.max_binary_size, "Binary")), true);
     }
 
     using OstreamReader = StreamReader<std::ifstream>;
@@ -16,18 +16,31 @@
 
 #include <fstream>
 #include <algorithm>
+#include <vector>
 #include "value.hpp"
 #include "stream_helpers.hpp"
 
 namespace timl {
 
-    std::pair<Type, bool> common_array_type(const Value&);
+    inline std::pair<Type, bool> common_array_type(const Value&);
+    inline std::pair<Marker, bool> common_array_marker(const Value&);
+
+    //! What a StreamWriter may emit beyond the plain encoding of a Value
+    struct StreamWriterOptions
+    {
+        //! Opens every Object with a Width hint, <tt>{ W width count ...</tt>, so readers can
+        //! prefetch it whole, or skip it without looking at its items. Writing then walks the Value twice
+        bool width_hints;
+    };
+
+    constexpr StreamWriterOptions defaultStreamWriterOptions()
+    { return {false}; }
 
     template<typename StreamType>
     class StreamWriter
     {
     public:
-        StreamWriter(StreamType& Stream);
+        StreamWriter(StreamType& Stream, StreamWriterOptions Options = defaultStreamWriterOptions());
 
         std::pair<std::size_t, bool> writeValue(const Value&);
         StreamType& getStream() { return stream; }
@@ -45,10 +58,12 @@ namespace timl {
         std::pair<size_t, bool> append_signedInt(long long);
         std::pair<size_t, bool> append_unsignedInt(unsigned long long, bool evaluate_uint64 = true);
         std::pair<size_t, bool> append_size(std::size_t);
+        std::pair<size_t, bool> append_fixed(Marker, uint64_t);
 
         std::pair<size_t, bool> append_string(const std::string&);
         std::pair<size_t, bool> append_binary(const Value::BinaryType&);
         std::pair<size_t, bool> append_array(const Value&);
+        std::pair<size_t, bool> append_homoArray(const Value&, Marker);
 
         void update(const std::pair<size_t, bool>&, std::pair<size_t, bool>&);
 
@@ -57,18 +72,32 @@ namespace timl {
         bool write(const byte *, std::size_t);
 
         StreamType& stream;
+        const StreamWriterOptions options;
+        bool measuring = false;             //! when set, nothing is written; only sizes are computed
+        std::vector<std::size_t> widths;    //! the Width hint of each Object, in the order they are written
+        std::size_t next_width = 0;
     };
 
 
     template<typename StreamType>
-    StreamWriter<StreamType>::StreamWriter(StreamType& Stream)
-        : stream(Stream) {}
+    StreamWriter<StreamType>::StreamWriter(StreamType& Stream, StreamWriterOptions Options)
+        : stream(Stream), options(Options) {}
 
     template<typename StreamType>
     std::pair<size_t, bool> StreamWriter<StreamType>::writeValue(const Value& value)
     {
         if(not value.isMap())
             return std::make_pair(0, false);
+
+        if(options.width_hints)
+        {
+            //An Object's Width hint precedes its items, so they are all measured upfront
+            widths.clear();
+            measuring = true;
+            append_object(value);
+            measuring = false;
+            next_width = 0;
+        }
         return append_object(value);
     }
 
@@ -78,6 +107,25 @@ namespace timl {
         auto keys = value.keys();
         std::pair<size_t, bool> rtn(1, false);
         write(Marker::Object_Start);
+
+        std::size_t width_slot = 0;
+        if(options.width_hints)
+        {
+            if(measuring)
+            {
+                width_slot = widths.size();
+                widths.push_back(0);
+            }
+            else
+            {
+                const std::size_t width = widths[next_width++];
+                write(Marker::Width);
+                update(append_size(width), rtn);
+                rtn.first += 1;
+            }
+        }
+
+        const std::size_t header = rtn.first;
         update(append_size(keys.size()), rtn);
 
         for(const auto& key : keys)
@@ -90,6 +138,14 @@ namespace timl {
         }
         write(Marker::Object_End);
         rtn.first += 1;
+
+        if(measuring)
+        {
+            //the hint counts everything after itself, so it can only be sized once the rest is known
+            const std::size_t width = rtn.first - header;
+            widths[width_slot] = width;
+            rtn.first += 1 + append_size(width).first;
+        }
         return rtn;
     }
 
@@ -97,26 +153,38 @@ namespace timl {
     std::pair<size_t, bool> StreamWriter<StreamType>::append_value(const Value& v)
     {
         std::pair<size_t, bool> k(0, false);
-        if(v.isNull())
+        switch (v.type()) {
+        case Type::Null:
             k = append_null();
-        else if(v.isBool())
+            break;
+        case Type::Bool:
             k = append_bool(v);
-        else if(v.isChar())
+            break;
+        case Type::Char:
             k = append_char(v);
-        else if(v.isSignedInteger())
+            break;
+        case Type::SignedInt:
             k = append_signedInt(v);
-        else if(v.isUnsignedInteger())
+            break;
+        case Type::UnsignedInt:
             k = append_unsignedInt(v);
-        else if(v.isFloat())
+            break;
+        case Type::Float:
             k = append_float(v);
-        else if(v.isString())
+            break;
+        case Type::String:
             k = append_string(v);
-        else if(v.isBinary())
+            break;
+        case Type::Binary:
             k = append_binary(v);
-        else if(v.isArray())
+            break;
+        case Type::Array:
             k = append_array(v);
-        else if(v.isObject())
+            break;
+        case Type::Map:
             k = append_object(v);
+            break;
+        }
         return k;
     }
 
@@ -135,6 +203,8 @@ namespace timl {
     template<typename StreamType>
     bool StreamWriter<StreamType>::write(const byte* b, std::size_t sz)
     {
+        if(measuring)
+            return true;
         stream.write(reinterpret_cast<const char*>(b), sz);
         return true;
     }
@@ -166,9 +236,7 @@ namespace timl {
     template<typename StreamType>
     std::pair<size_t, bool> StreamWriter<StreamType>::append_char(char c)
     {
-        write(static_cast<byte>(Marker::Char));
-        write(static_cast<byte>(c));
-        return std::make_pair(2, true);
+        return append_fixed(Marker::Char, static_cast<byte>(c));
     }
 
     template<typename StreamType>
@@ -221,43 +289,15 @@ namespace timl {
         using Uint32 = std::numeric_limits<uint32_t>;
         using Uint64 = std::numeric_limits<uint64_t>;
 
-        byte b[8];
-        std::pair<size_t, bool> rtn(0, false);
         if(in_range(val, Uint8::lowest(), Uint8::max()))
-        {
-            write(Marker::Uint8);
-            write(static_cast<byte>(val));
-            rtn = std::make_pair(2, true);
-        }
-        else if(in_range(val, Uint16::lowest(), Uint16::max()))
-        {
-            const uint16_t ct = static_cast<uint16_t>(val);
-            const uint16_t val = toBigEndian16(ct);
-            std::memcpy(b, &val, 2);
-            write(Marker::Uint16);
-            write(b, 2);
-            rtn = std::make_pair(3, true);
-        }
-        else if(in_range(val, Uint32::lowest(), Uint32::max()))
-        {
-            const uint32_t ct = static_cast<uint32_t>(val);
-            const uint32_t val = toBigEndian32(ct);
-            std::memcpy(b, &val, 4);
-            write(Marker::Uint32);
-            write(b, 4);
-            rtn = std::make_pair(5, true);
-        }
-        else if(evaluate_uint64 and in_range(val, Uint64::lowest(), Uint64::max()))
-        {
-            const uint64_t ct = static_cast<uint64_t>(val);
-            const uint64_t val = toBigEndian64(ct);
-            std::memcpy(b, &val, 8);
-            write(Marker::Uint64);
-            write(b, 8);
-            rtn = std::make_pair(9, true);
-        }
-
-        return rtn;
+            return append_fixed(Marker::Uint8, val);
+        if(in_range(val, Uint16::lowest(), Uint16::max()))
+            return append_fixed(Marker::Uint16, val);
+        if(in_range(val, Uint32::lowest(), Uint32::max()))
+            return append_fixed(Marker::Uint32, val);
+        if(evaluate_uint64 and in_range(val, Uint64::lowest(), Uint64::max()))
+            return append_fixed(Marker::Uint64, val);
+        return std::make_pair(0, false);
     }
 
     template<typename StreamType>
@@ -277,44 +317,16 @@ namespace timl {
             return append_unsignedInt(val);
         //End Optimization
 
-
-        byte b[8];
-        std::pair<size_t, bool> rtn(0, false);
+        const uint64_t bits = static_cast<uint64_t>(val);
         if(in_range(val, Int8::lowest(), Int8::max()))
-        {
-            write(Marker::Int8);
-            write(static_cast<byte>(val));
-            rtn = std::make_pair(2, true);
-        }
-        else if(in_range(val, Int16::lowest(), Int16::max()))
-        {
-            const uint16_t tit = static_cast<uint16_t>(val);
-            const uint16_t val = toBigEndian16(tit);
-            std::memcpy(b, &val, 2);
-            write(Marker::Int16);
-            write(b, 2);
-            rtn = std::make_pair(3, true);
-        }
-        else if(in_range(val, Int32::lowest(), Int32::max()))
-        {
-            const uint32_t tit = static_cast<uint32_t>(val);
-            const uint32_t val = toBigEndian32(tit);
-            std::memcpy(b, &val, 4);
-            write(Marker::Int32);
-            write(b, 4);
-            rtn = std::make_pair(5, true);
-        }
-        else if(in_range(val, Int64::lowest(), Int64::max()))
-        {
-            const uint64_t tit = static_cast<uint64_t>(val);
-            const uint64_t val = toBigEndian64(tit);
-            std::memcpy(b, &val, 8);
-            write(Marker::Int64);
-            write(b, 8);
-            rtn = std::make_pair(9, true);
-        }
-
-        return rtn;
+            return append_fixed(Marker::Int8, bits);
+        if(in_range(val, Int16::lowest(), Int16::max()))
+            return append_fixed(Marker::Int16, bits);
+        if(in_range(val, Int32::lowest(), Int32::max()))
+            return append_fixed(Marker::Int32, bits);
+        if(in_range(val, Int64::lowest(), Int64::max()))
+            return append_fixed(Marker::Int64, bits);
+        return std::make_pair(0, false);
     }
 
     template<typename StreamType>
@@ -323,31 +335,45 @@ namespace timl {
         using Float32 = std::numeric_limits<float>;
         using Float64 = std::numeric_limits<double>;
 
-        byte b[8];
-        std::pair<size_t, bool> rtn(0, false);
         if(in_range(val, Float32::lowest(), Float32::max()) and static_cast<float>(val) == val)
         {
-            const uint32_t val_i = toBigEndianFloat32(static_cast<float>(val));
-            std::memcpy(b, &val_i, 4);
-            write(Marker::Float32);
-            write(b, 4);
-            rtn = std::make_pair(5, true);
+            const float f = static_cast<float>(val);
+            uint32_t bits;
+            std::memcpy(&bits, &f, 4);
+            return append_fixed(Marker::Float32, bits);
         }
-        else if(in_range(val, Float64::lowest(), Float64::max()))
+        if(in_range(val, Float64::lowest(), Float64::max()))
         {
-            const uint64_t val_i = toBigEndianFloat64(val);
-            std::memcpy(b, &val_i, 8);
-            write(Marker::Float64);
-            write(b, 8);
-            rtn = std::make_pair(9, true);
+            uint64_t bits;
+            std::memcpy(&bits, &val, 8);
+            return append_fixed(Marker::Float64, bits);
         }
+        return std::make_pair(0, false);
+    }
 
-        return rtn;
+    /*!
+     * writes \a m followed by the lowest markerInfo(m).width bytes of \a bits in big endian order,
+     * with a single write to the stream
+     */
+    template<typename StreamType>
+    std::pair<size_t, bool> StreamWriter<StreamType>::append_fixed(Marker m, uint64_t bits)
+    {
+        const std::size_t width = markerInfo(static_cast<byte>(m)).width;
+        const uint64_t payload = toBigEndian64(bits << (64 - 8 * width));
+        byte b[9];
+        b[0] = static_cast<byte>(m);
+        std::memcpy(b + 1, &payload, 8);
+        write(b, 1 + width);
+        return std::make_pair(1 + width, true);
     }
 
     template<typename StreamType>
     std::pair<size_t, bool> StreamWriter<StreamType>::append_array(const Value& value)
     {
+        const auto homogenous = common_array_marker(value);
+        if(homogenous.second)
+            return append_homoArray(value, homogenous.first);
+
         std::pair<size_t, bool> rtn(2, false);
         const std::size_t size = value.size();
         write(Marker::HetroArray_Start);
@@ -360,23 +386,93 @@ namespace timl {
 
         write(Marker::HetroArray_End);
         return rtn;
-
-        //! \todo TODO... detect homogenepus arrays and treat accordingly
-        //! WORK in progress
-
     }
 
+    /*!
+     * writes \a value as a homogenous Array, <tt>( m count items... )</tt>, where every item is
+     * written without its marker \a m. Fixed width items are batched into few writes to the stream
+     */
+    template<typename StreamType>
+    std::pair<size_t, bool> StreamWriter<StreamType>::append_homoArray(const Value& value, Marker m)
+    {
+        std::pair<size_t, bool> rtn(3, true);
+        write(Marker::HomoArray_Start);
+        write(m);
+        update(append_size(value.size()), rtn);
 
+        const MarkerInfo& info = markerInfo(static_cast<byte>(m));
+        if(info.kind == MarkerKind::String or info.kind == MarkerKind::Binary)
+        {
+            for(const Value& item : value)
+            {
+                if(info.kind == MarkerKind::String)
+                {
+                    const std::string& str = item;
+                    update(append_size(str.size()), rtn);
+                    write(reinterpret_cast<const byte*>(str.data()), str.size());
+                    rtn.first += str.size();
+                }
+                else
+                {
+                    const Value::BinaryType& bin = item;
+                    update(append_size(bin.size()), rtn);
+                    write(bin.data(), bin.size());
+                    rtn.first += bin.size();
+                }
+            }
+        }
+        else
+        {
+            //each item is stored as a full 8 bytes; the next one overwrites all but its lowest width bytes
+            const std::size_t width = info.width;
+            byte chunk[256 * 8 + 8];
+            std::size_t used = 0;
+            for(const Value& item : value)
+            {
+                uint64_t bits;
+                switch (info.kind) {
+                case MarkerKind::Char:
+                    bits = static_cast<byte>(static_cast<char>(item));
+                    break;
+                case MarkerKind::UnsignedInt:
+                    bits = item.asUint64();
+                    break;
+                case MarkerKind::Float:
+                    if(width == 4)
+                    {
+                        const float f = static_cast<float>(item.asFloat());
+                        uint32_t b32;
+                        std::memcpy(&b32, &f, 4);
+                        bits = b32;
+                    }
+                    else
+                    {
+                        const double d = item.asFloat();
+                        std::memcpy(&bits, &d, 8);
+                    }
+                    break;
+                default:
+                    bits = static_cast<uint64_t>(item.asInt64());
+                    break;
+                }
+                const uint64_t payload = toBigEndian64(bits << (64 - 8 * width));
+                std::memcpy(chunk + used, &payload, 8);
+                used += width;
+                if(used > sizeof(chunk) - 16)
+                {
+                    write(chunk, used);
+                    used = 0;
+                }
+            }
+            write(chunk, used);
+            rtn.first += width * value.size();
+        }
 
+        write(Marker::HomoArray_End);
+        return rtn;
+    }
 
-
-
-
-
-
-
-
-    std::pair<Type, bool> common_array_type(const Value& value)
+    inline std::pair<Type, bool> common_array_type(const Value& value)
     {
         std::pair<Type, bool> rtn(Type::Null, false);
 
@@ -395,13 +491,88 @@ namespace timl {
         return rtn;
     }
 
+    /*!
+     * \brief the marker of the narrowest type every item of \a value can be written as without loss,
+     * if \a value is an Array that can be written as a homogenous Array. It takes the same items as
+     * common_array_type(), but finds their type and range in a single walk over them
+     */
+    inline std::pair<Marker, bool> common_array_marker(const Value& value)
+    {
+        const std::pair<Marker, bool> none(Marker::Null, false);
+        if(not value.isArray() or value.size() < 2)
+            return none;
+
+        const Type type = value[0].type();
+        if(not isDirectType(type) and not isSequenceType(type))
+            return none;
+
+        long long lo = 0;
+        unsigned long long hi = 0;
+        bool float32 = true;
+        for(const Value& item : value)
+        {
+            if(item.type() != type)
+                return none;
+            switch (type) {
+            case Type::SignedInt:
+            {
+                const long long v = item.asInt64();
+                lo = std::min(lo, v);
+                hi = std::max(hi, v < 0 ? 0ull : static_cast<unsigned long long>(v));
+                break;
+            }
+            case Type::UnsignedInt:
+                hi = std::max(hi, item.asUint64());
+                break;
+            case Type::Float:
+            {
+                const double v = item.asFloat();
+                //append_float() refuses what isn't finite, so the Array is left for it to refuse
+                if(not in_range(v, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max()))
+                    return none;
+                float32 = float32 and in_range(v, std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max())
+                                  and static_cast<float>(v) == v;
+                break;
+            }
+            default:
+                break;
+            }
+        }
 
+        switch (type) {
+        case Type::Char:
+            return std::make_pair(Marker::Char, true);
+        case Type::String:
+            return std::make_pair(Marker::String, true);
+        case Type::Binary:
+            return std::make_pair(Marker::Binary, true);
+        case Type::Float:
+            return std::make_pair(float32 ? Marker::Float32 : Marker::Float64, true);
+        default:
+            break;
+        }
 
-
-
-
+        //just like append_signedInt(), integers that are all positive are written unsigned
+        if(lo < 0)
+        {
+            const long long top = static_cast<long long>(hi);
+            if(lo >= std::numeric_limits<int8_t>::lowest() and top <= std::numeric_limits<int8_t>::max())
+                return std::make_pair(Marker::Int8, true);
+            if(lo >= std::numeric_limits<int16_t>::lowest() and top <= std::numeric_limits<int16_t>::max())
+                return std::make_pair(Marker::Int16, true);
+            if(lo >= std::numeric_limits<int32_t>::lowest() and top <= std::numeric_limits<int32_t>::max())
+                return std::make_pair(Marker::Int32, true);
+            return std::make_pair(Marker::Int64, true);
+        }
+        if(hi <= std::numeric_limits<uint8_t>::max())
+            return std::make_pair(Marker::Uint8, true);
+        if(hi <= std::numeric_limits<uint16_t>::max())
+            return std::make_pair(Marker::Uint16, true);
+        if(hi <= std::numeric_limits<uint32_t>::max())
+            return std::make_pair(Marker::Uint32, true);
+        return std::make_pair(Marker::Uint64, true);
+    }
 
 }   //end namespace timl
 
 #endif // STREAM_WRITER_HPP
-
@@ -141,6 +141,91 @@ namespace timl {
     { return isObjectStart(b) or isString(b) or isBinary(b) or isHomoArrayStart(b) or isHetroArrayStart(b); }
 
 
+    //////////////////////////////////////
+    ///
+    /// Marker table, for dispatching on a marker with a single lookup
+    ///
+
+    /*!
+     * \enum MarkerKind
+     * \brief What a marker introduces; the index the reader dispatches on
+     */
+    enum class MarkerKind : byte
+    {
+        Invalid,        //!< not a value marker
+        Null,
+        True,
+        False,
+        Char,
+        SignedInt,
+        UnsignedInt,
+        Float,
+        String,
+        Binary,
+        Object,
+        HetroArray,
+        HomoArray
+    };
+
+    //! Everything needed to decode, or step over, the value a marker introduces
+    struct MarkerInfo
+    {
+        MarkerKind kind;
+        Type type;          //! the Type of the decoded Value, Type::Null for Invalid markers
+        byte width;         //! bytes of a fixed size payload; 0 if it has none or is size prefixed
+        bool is_signed;
+    };
+
+    constexpr MarkerInfo describeMarker(byte b)
+    {
+        switch (static_cast<Marker>(b)) {
+        case Marker::Null:      return {MarkerKind::Null, Type::Null, 0, false};
+        case Marker::True:      return {MarkerKind::True, Type::Bool, 0, false};
+        case Marker::False:     return {MarkerKind::False, Type::Bool, 0, false};
+        case Marker::Char:      return {MarkerKind::Char, Type::Char, 1, false};
+        case Marker::Int8:      return {MarkerKind::SignedInt, Type::SignedInt, 1, true};
+        case Marker::Int16:     return {MarkerKind::SignedInt, Type::SignedInt, 2, true};
+        case Marker::Int32:     return {MarkerKind::SignedInt, Type::SignedInt, 4, true};
+        case Marker::Int64:     return {MarkerKind::SignedInt, Type::SignedInt, 8, true};
+        case Marker::Uint8:     return {MarkerKind::UnsignedInt, Type::UnsignedInt, 1, false};
+        case Marker::Uint16:    return {MarkerKind::UnsignedInt, Type::UnsignedInt, 2, false};
+        case Marker::Uint32:    return {MarkerKind::UnsignedInt, Type::UnsignedInt, 4, false};
+        case Marker::Uint64:    return {MarkerKind::UnsignedInt, Type::UnsignedInt, 8, false};
+        case Marker::Float32:   return {MarkerKind::Float, Type::Float, 4, true};
+        case Marker::Float64:   return {MarkerKind::Float, Type::Float, 8, true};
+        case Marker::String:    return {MarkerKind::String, Type::String, 0, false};
+        case Marker::Binary:    return {MarkerKind::Binary, Type::Binary, 0, false};
+        case Marker::Object_Start:      return {MarkerKind::Object, Type::Map, 0, false};
+        case Marker::HetroArray_Start:  return {MarkerKind::HetroArray, Type::Array, 0, false};
+        case Marker::HomoArray_Start:   return {MarkerKind::HomoArray, Type::Array, 0, false};
+        default:                return {MarkerKind::Invalid, Type::Null, 0, false};
+        }
+    }
+
+    struct MarkerTable
+    {
+        MarkerInfo info[256];
+    };
+
+    constexpr MarkerTable makeMarkerTable()
+    {
+        MarkerTable table{};
+        for(unsigned i = 0; i < 256; ++i)
+            table.info[i] = describeMarker(static_cast<byte>(i));
+        return table;
+    }
+
+    //! describeMarker() of every byte, computed at compile time
+    constexpr MarkerTable marker_table = makeMarkerTable();
+
+    constexpr const MarkerInfo& markerInfo(byte b)
+    { return marker_table.info[b]; }
+
+    static_assert(markerInfo('l').width == 8 and markerInfo('l').is_signed, "Int64 marker is mis-described");
+    static_assert(markerInfo('(').kind == MarkerKind::HomoArray, "HomoArray marker is mis-described");
+    static_assert(markerInfo('}').kind == MarkerKind::Invalid, "end markers don't introduce values");
+
+
     //////////////////////////////////////
     ///
     /// FOR TYPE detection According to standard
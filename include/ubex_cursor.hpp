@@ -0,0 +1,348 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file ubex_cursor.hpp
+  * A pull parser over the documents of a StreamReader
+  *
+  * @brief UbexCursor
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef UBEX_CURSOR_HPP
+#define UBEX_CURSOR_HPP
+
+#include <cstring>
+#include <vector>
+#include "stream_reader.hpp"
+
+namespace timl {
+
+    //! What UbexCursor::next() stepped onto
+    enum class Token
+    {
+        ObjectStart,
+        ObjectEnd,
+        ArrayStart,
+        ArrayEnd,
+        Null,
+        Bool,
+        Char,
+        SignedInt,
+        UnsignedInt,
+        Float,
+        String,
+        Binary,
+        End,        //!< the source has no more documents
+        Error       //!< see UbexCursor::getLastError(); the cursor stays here
+    };
+
+
+    /*!
+     * \brief The UbexCursor class
+     * Pulls one token at a time out of the documents read by a StreamReader,
+     * so protocol code can read exactly what it needs, in order, and stop early.
+     *
+     * \code
+     * BufferReader reader(span);
+     * BufferCursor cursor(reader);
+     * cursor.next();                           // Token::ObjectStart, the document itself
+     * while(cursor.next() != Token::ObjectEnd)
+     * {
+     *      if(cursor.key() == "id")
+     *          id = cursor.asInt64();
+     *      else if(cursor.isContainerStart())
+     *          cursor.skip();                  // steps over the whole subtree
+     * }
+     * \endcode
+     *
+     * Every Object member is preceded by its key(); it stays valid until the next call to next().
+     * So does the payload of String and Binary tokens. Once a document's last ObjectEnd has been
+     * returned, next() moves on to the following document, or returns Token::End.
+     *
+     * \a SizePolicy is that of the reader, ValueSizePolicy unless given; see the declaration in stream_reader.hpp
+     */
+    template<typename StreamType, typename SizePolicy>
+    class UbexCursor
+    {
+    public:
+        explicit UbexCursor(StreamReader<StreamType, SizePolicy>& Reader)
+            : reader(Reader) {}
+
+        //! advances to the next token, and returns it
+        Token next();
+
+        /*!
+         * \brief if the current token opens a container, steps over everything up to its end
+         * without decoding it; the current token then becomes the matching ObjectEnd/ArrayEnd.
+         * Objects that carry a Width hint are stepped over without looking at their items.
+         * Otherwise it does nothing.
+         * \return false on a decoding error
+         */
+        bool skip();
+
+        /*!
+         * \brief if the current token opens a homogenous Array of integers or floats, decodes all
+         * its items into \a out with a single read and a bulk byteswap; the current token then becomes
+         * the matching ArrayEnd. Items are converted with static_cast, see NumericArray::copyTo()
+         * \return false on a decoding error, or for every other token; those are left as they are
+         */
+        template<typename T>
+        bool readNumbers(std::vector<T>& out);
+
+        //! whether the current token opens an Array readNumbers() can decode
+        bool isNumericArrayStart() const noexcept
+        { return tok == Token::ArrayStart and stack.back().type == MarkerType::HomoArray and isBulkNumeric(stack.back().type_mark); }
+
+        Token token() const noexcept { return tok; }
+
+        //! whether the current token is ObjectStart or ArrayStart
+        bool isContainerStart() const noexcept { return tok == Token::ObjectStart or tok == Token::ArrayStart; }
+
+        //! the key of the current value if it's a member of an Object, else an empty StringRef
+        StringRef key() const noexcept { return current_key; }
+
+        //! the item count of the container the current token opens
+        std::size_t count() const noexcept { return item_count; }
+
+        //! the number of containers the current token is nested in, the document itself included
+        std::size_t depth() const noexcept { return stack.size(); }
+
+        bool                asBool()   const noexcept { return scalar.Bool; }
+        char                asChar()   const noexcept { return scalar.Char; }
+        long long           asInt64()  const noexcept { return scalar.SignedInt; }
+        unsigned long long  asUint64() const noexcept { return scalar.UnsignedInt; }
+        double              asFloat()  const noexcept { return scalar.Float; }
+        StringRef           asString() const noexcept { return string_payload; }
+        ByteSpan            asBinary() const noexcept { return binary_payload; }
+
+        std::string getLastError() const { return last_error; }
+
+        StreamReader<StreamType, SizePolicy>& getReader() { return reader; }
+
+    private:
+        using Frame = ContainerFrame;
+
+        //! the Handler the reader's scalar decoding reports to
+        struct ScalarSink
+        {
+            UbexCursor& c;
+            void null()                         { c.tok = Token::Null; }
+            void boolean(bool b)                { c.tok = Token::Bool; c.scalar.Bool = b; }
+            void character(char ch)             { c.tok = Token::Char; c.scalar.Char = ch; }
+            void int64(long long ll)            { c.tok = Token::SignedInt; c.scalar.SignedInt = ll; }
+            void uint64(unsigned long long ull) { c.tok = Token::UnsignedInt; c.scalar.UnsignedInt = ull; }
+            void float64(double d)              { c.tok = Token::Float; c.scalar.Float = d; }
+            void string(StringRef s)            { c.tok = Token::String; c.string_payload = s; }
+            void binary(ByteSpan b)             { c.tok = Token::Binary; c.binary_payload = b; }
+        };
+
+        void start_document();
+        byte next_member(Frame& f);
+        void open_container(byte marker);
+        Token close_container();
+        void fail(const char* what);
+
+        StreamReader<StreamType, SizePolicy>& reader;
+        std::vector<Frame> stack;
+        std::size_t skip_hint = 0;  //! the Width hint of the container the current token opens, if any
+        Token tok = Token::End;
+        std::size_t item_count = 0;
+        std::string last_error;
+
+        StringRef current_key;
+        char key_buffer[256];   //! stream sources may overwrite the bytes a key view points to
+
+        union
+        {
+            bool Bool;
+            char Char;
+            long long SignedInt;
+            unsigned long long UnsignedInt;
+            double Float;
+        } scalar;
+        StringRef string_payload;
+        ByteSpan binary_payload;
+    };
+
+    //! A UbexCursor over a BufferReader
+    using BufferCursor = UbexCursor<ByteSpan>;
+
+
+    template<typename StreamType, typename SizePolicy>
+    Token UbexCursor<StreamType, SizePolicy>::next()
+    {
+        if(tok == Token::Error)
+            return tok;
+
+        try
+        {
+            current_key = StringRef();
+            skip_hint = 0;
+            if(stack.empty())
+            {
+                start_document();
+                return tok;
+            }
+
+            Frame& f = stack.back();
+            if(f.remaining == 0)
+                return tok = close_container();
+
+            --f.remaining;
+            const byte marker = next_member(f);
+            ScalarSink sink{*this};
+            if(not reader.extract_singleValueTo(marker, sink))
+                open_container(marker);
+        }
+        catch(parsing_exception& pexcept)
+        {
+            fail(pexcept.what());
+        }
+        return tok;
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    bool UbexCursor<StreamType, SizePolicy>::skip()
+    {
+        if(not isContainerStart())
+            return tok != Token::Error;
+
+        try
+        {
+            Frame& f = stack.back();
+            if(skip_hint > 0)
+            {
+                reader.skip_bytes(skip_hint - 1);
+                f.remaining = 0;
+            }
+            while(f.remaining > 0)
+            {
+                --f.remaining;
+                reader.skip_value(next_member(f));
+            }
+            tok = close_container();
+        }
+        catch(parsing_exception& pexcept)
+        {
+            fail(pexcept.what());
+            return false;
+        }
+        current_key = StringRef();
+        return true;
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    template<typename T>
+    bool UbexCursor<StreamType, SizePolicy>::readNumbers(std::vector<T>& out)
+    {
+        if(not isNumericArrayStart())
+            return false;
+
+        try
+        {
+            Frame& f = stack.back();
+            const NumericArray items = reader.extract_numericArray(f);
+            out.resize(items.size());
+            items.copyTo(out.data());
+            f.remaining = 0;
+            tok = close_container();
+        }
+        catch(parsing_exception& pexcept)
+        {
+            fail(pexcept.what());
+            return false;
+        }
+        current_key = StringRef();
+        return true;
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    void UbexCursor<StreamType, SizePolicy>::start_document()
+    {
+        if(reader.atEnd())
+        {
+            tok = Token::End;
+            return;
+        }
+
+        reader.begin_value();
+        byte b;
+        reader.read(b);
+        if(not isObjectStart(b))
+            throw parsing_exception(ParseError::NotAnObject);
+        open_container(b);
+    }
+
+    //! reads up to the marker of the next member of \a f; for Objects, that includes its key
+    template<typename StreamType, typename SizePolicy>
+    byte UbexCursor<StreamType, SizePolicy>::next_member(Frame& f)
+    {
+        byte marker = f.type_mark;
+        switch (f.type) {
+        case MarkerType::Object:
+        {
+            StringRef k = reader.extract_Key().first;
+            if(not stream_source<StreamType>::contiguous)
+            {
+                std::memcpy(key_buffer, k.data(), k.size());
+                k = StringRef(key_buffer, k.size());
+            }
+            current_key = k;
+            reader.read(marker);
+            break;
+        }
+        case MarkerType::HetroArray:
+            reader.read(marker);
+            break;
+        case MarkerType::HomoArray:
+        default:
+            break;
+        }
+        return marker;
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    void UbexCursor<StreamType, SizePolicy>::open_container(byte marker)
+    {
+        if(stack.size() >= reader.vsz.max_value_depth)
+            throw parsing_exception(ParseError::TooDeep);
+
+        const Frame f = reader.extract_containerHeader(marker, skip_hint);
+        tok = f.type == MarkerType::Object ? Token::ObjectStart : Token::ArrayStart;
+        item_count = f.remaining;
+        stack.push_back(f);
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    Token UbexCursor<StreamType, SizePolicy>::close_container()
+    {
+        const Frame f = stack.back();
+        if(not f.end_consumed)
+            reader.validate_container_end(f.type);
+        stack.pop_back();
+        return f.type == MarkerType::Object ? Token::ObjectEnd : Token::ArrayEnd;
+    }
+
+    template<typename StreamType, typename SizePolicy>
+    void UbexCursor<StreamType, SizePolicy>::fail(const char* what)
+    {
+        last_error = what;
+        tok = Token::Error;
+        stack.clear();
+    }
+
+}   //end namespace timl
+
+#endif // UBEX_CURSOR_HPP
@@ -0,0 +1,57 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+/**
+  * @file validate.hpp
+  * Checks that a buffer holds a well formed document, without decoding it
+  *
+  * @brief validate
+  * @author WhiZTiM
+  *
+  */
+
+#ifndef VALIDATE_HPP
+#define VALIDATE_HPP
+
+#include <cstddef>
+#include "value.hpp"
+#include "byte_span.hpp"
+#include "stream_reader.hpp"
+#include "parse_result.hpp"
+
+namespace timl {
+
+    /*!
+     * \brief checks the Object at the start of \a bytes without decoding it, nor allocating for it
+     *
+     * Every marker, count and container end is checked, along with the limits of \a policy that
+     * StreamReader::getNextValue() enforces: a document is valid if and only if it decodes. Except that a Width
+     * hint also has to match the size of its Object, since readers may step over the Object by the hint alone.
+     *
+     * Items are stepped over rather than looked at whenever their size is known upfront, e.g the payload of
+     * Strings, or all the items of a homogenous Array of numbers. Bytes after the Object are left alone; the
+     * offset of a valid result is where the next document of \a bytes starts.
+     *
+     * \code
+     * ParseResult r = validate(message, policy);
+     * if(not r)
+     *      reject(message, r.offset, r.message());
+     * \endcode
+     *
+     * Nothing throws; objects nesting deeper than 32 levels need a heap allocation for their bookkeeping.
+     */
+    ParseResult validate(ByteSpan bytes, const ValueSizePolicy& policy = defaultStreamReaderPolicy());
+
+}   //end namespace timl
+
+#endif // VALIDATE_HPP
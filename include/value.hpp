@@ -52,9 +52,11 @@
 #include "exception.hpp"
 #include "iterator.hpp"
 #include "types.hpp"
+#include "key_table.hpp"
 
 namespace timl {
 
+    class ValueRecycler;
 
     /*!
      * \brief The Value class
@@ -79,8 +81,8 @@ namespace timl {
         //! \note \a byte is an alias for \e unsigned \e char
         using BinaryType = std::vector<byte>;
 
-        //! An alias used to internally represent \ref Type "Map" types
-        using MapType = std::unordered_map<std::string, Uptr>;
+        //! An alias used to internally represent \ref Type "Map" types; keys decoded with a KeyTable share their characters
+        using MapType = std::unordered_map<Key, Uptr, KeyHash>;
 
         //! Iterator alias for accessing values of an iterable value object
         using iterator = value_iterator<Value, ArrayType::iterator, MapType::iterator>;
@@ -90,6 +92,7 @@ namespace timl {
 
         friend iterator;
         friend const_iterator;
+        friend class ValueRecycler;     //! refills the containers of a Value in place
 
 
         /*!
@@ -411,6 +414,32 @@ namespace timl {
         void push_back(const Value&);
         void push_back(Value&&);
 
+        /*!
+         * \brief stores \a v under \a key with a single lookup, replacing what was there
+         * \pre isMap() or isNull(); a Null Value becomes a Map, just like with operator []
+         * \return the stored Value
+         */
+        Value& emplace(Key key, Value&& v);
+
+        /*!
+         * \brief appends \a v as push_back() does
+         * \return the stored Value
+         */
+        Value& emplace_back(Value&& v);
+
+        /*!
+         * \brief moves the items of the Array \a items to the end of this one, without copying or reallocating them.
+         * A Null \a items is an empty Array and appends nothing; any other Value is appended as push_back() does
+         * \pre \a items is not this Value
+         */
+        void append(Value&& items);
+
+        /*!
+         * \brief makes room for \a n items in an Array or a Map, so adding them doesn't reallocate or rehash.
+         * Other types, Null included, have no items to make room for; it then does nothing
+         */
+        void reserve(std::size_t n);
+
         bool contains(const Value&) const;
         void remove(const Value&);
 
@@ -590,7 +619,8 @@ namespace timl {
      */
     struct ValueSizePolicy      //NOTE: Please never reorder the members, because, brace initializer{}
     {
-        //! This prevents stack overflow if the parser is implemented using some recursive technique
+        //! This dictates how deeply containers may nest. The parser keeps one small frame per level
+        //! on the heap, so this bounds memory rather than guarding the call stack
         std::size_t max_value_depth;
 
         //! This dictates the maximum size in bytes a binary type can have
@@ -46,6 +46,21 @@ int main()
     extern int weird_cppunit_extern_bug_value_conversion_test;      weird_cppunit_extern_bug_value_conversion_test = 1;
     extern int weird_cppunit_extern_bug_value_map_and_array_test;   weird_cppunit_extern_bug_value_map_and_array_test = 1;
     extern int weird_cppunit_extern_bug_value_iterator_test;        weird_cppunit_extern_bug_value_iterator_test = 1;
+    extern int weird_cppunit_extern_bug_stream_reader_test;         weird_cppunit_extern_bug_stream_reader_test = 1;
+    extern int weird_cppunit_extern_bug_mapped_file_test;           weird_cppunit_extern_bug_mapped_file_test = 1;
+    extern int weird_cppunit_extern_bug_event_parser_test;          weird_cppunit_extern_bug_event_parser_test = 1;
+    extern int weird_cppunit_extern_bug_ubex_cursor_test;           weird_cppunit_extern_bug_ubex_cursor_test = 1;
+    extern int weird_cppunit_extern_bug_lazy_value_test;            weird_cppunit_extern_bug_lazy_value_test = 1;
+    extern int weird_cppunit_extern_bug_endian_kernels_test;        weird_cppunit_extern_bug_endian_kernels_test = 1;
+    extern int weird_cppunit_extern_bug_document_stream_test;       weird_cppunit_extern_bug_document_stream_test = 1;
+    extern int weird_cppunit_extern_bug_parallel_document_reader_test; weird_cppunit_extern_bug_parallel_document_reader_test = 1;
+    extern int weird_cppunit_extern_bug_parallel_value_decoder_test;   weird_cppunit_extern_bug_parallel_value_decoder_test = 1;
+    extern int weird_cppunit_extern_bug_validate_test;              weird_cppunit_extern_bug_validate_test = 1;
+    extern int weird_cppunit_extern_bug_push_parser_test;           weird_cppunit_extern_bug_push_parser_test = 1;
+    extern int weird_cppunit_extern_bug_async_fd_test;              weird_cppunit_extern_bug_async_fd_test = 1;
+    extern int weird_cppunit_extern_bug_key_table_test;             weird_cppunit_extern_bug_key_table_test = 1;
+    extern int weird_cppunit_extern_bug_document_test;              weird_cppunit_extern_bug_document_test = 1;
+    extern int weird_cppunit_extern_bug_value_recycler_test;        weird_cppunit_extern_bug_value_recycler_test = 1;
 
     auto v1 = tst();
     auto v2 = tst2();
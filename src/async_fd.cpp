@@ -0,0 +1,296 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "async_fd.hpp"
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace timl;
+
+EventLoop::EventLoop()
+    : epoll_fd(::epoll_create1(EPOLL_CLOEXEC))
+{
+    if(epoll_fd < 0)
+        throw std::system_error(errno, std::generic_category(), "Cannot create an epoll instance");
+}
+
+EventLoop::~EventLoop()
+{
+    ::close(epoll_fd);
+}
+
+void EventLoop::whenReadable(int fd, std::function<void()> callback)
+{
+    auto found = waiters.find(fd);
+    const bool registered = found != waiters.end();
+    Waiters& w = registered ? found->second : waiters[fd];
+    if(not w.readable)
+        ++waiting;
+    w.readable = std::move(callback);
+    update(fd, w, registered);
+}
+
+void EventLoop::whenWritable(int fd, std::function<void()> callback)
+{
+    auto found = waiters.find(fd);
+    const bool registered = found != waiters.end();
+    Waiters& w = registered ? found->second : waiters[fd];
+    if(not w.writable)
+        ++waiting;
+    w.writable = std::move(callback);
+    update(fd, w, registered);
+}
+
+void EventLoop::post(std::function<void()> callback)
+{
+    posted.push_back(std::move(callback));
+}
+
+void EventLoop::forget(int fd)
+{
+    auto found = waiters.find(fd);
+    if(found == waiters.end())
+        return;
+    waiting -= bool(found->second.readable) + bool(found->second.writable);
+    waiters.erase(found);
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+//! makes epoll watch \a fd for the directions \a w waits on, or stop watching it if there are none
+void EventLoop::update(int fd, const Waiters& w, bool registered)
+{
+    epoll_event ev{};
+    ev.events = (w.readable ? EPOLLIN : 0u) | (w.writable ? EPOLLOUT : 0u);
+    ev.data.fd = fd;
+
+    int op = registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if(ev.events == 0)
+    {
+        waiters.erase(fd);
+        op = EPOLL_CTL_DEL;
+    }
+    if(::epoll_ctl(epoll_fd, op, fd, &ev) != 0)
+        throw std::system_error(errno, std::generic_category(), "Cannot watch fd " + std::to_string(fd));
+}
+
+std::size_t EventLoop::runOnce(int timeout_ms)
+{
+    std::size_t ran = 0;
+
+    //callbacks posted meanwhile wait for the next round, so that the fds get their turn
+    for(std::size_t n = posted.size(); n > 0; --n, ++ran)
+    {
+        std::function<void()> callback = std::move(posted.front());
+        posted.pop_front();
+        callback();
+    }
+    if(waiting == 0)
+        return ran;
+
+    epoll_event events[256];
+    const int ready = ::epoll_wait(epoll_fd, events, 256, posted.empty() and ran == 0 ? timeout_ms : 0);
+    if(ready < 0)
+    {
+        if(errno == EINTR)
+            return ran;
+        throw std::system_error(errno, std::generic_category(), "epoll_wait failed");
+    }
+
+    for(int i = 0; i < ready; ++i)
+    {
+        const int fd = events[i].data.fd;
+        auto found = waiters.find(fd);
+        if(found == waiters.end())
+            continue;
+
+        //errors and hang ups wake both directions up, the reads and writes that follow tell what happened
+        const bool broken = events[i].events & (EPOLLERR | EPOLLHUP);
+        std::function<void()> readable, writable;
+        if((events[i].events & EPOLLIN) or broken)
+            readable.swap(found->second.readable);
+        if((events[i].events & EPOLLOUT) or broken)
+            writable.swap(found->second.writable);
+        waiting -= bool(readable) + bool(writable);
+        update(fd, found->second, true);
+
+        //the callbacks may wait on fd anew, which the update above must not undo
+        if(readable)
+        {
+            readable();
+            ++ran;
+        }
+        if(writable)
+        {
+            writable();
+            ++ran;
+        }
+    }
+    return ran;
+}
+
+void EventLoop::run()
+{
+    while(pending() > 0)
+        runOnce();
+}
+
+
+AsyncReader::AsyncReader(EventLoop& Loop, int fd, ValueSizePolicy policy, std::size_t buffer_size)
+    : loop(Loop), file(fd), parser(policy), buffer(std::max<std::size_t>(buffer_size, 1))
+{
+}
+
+IoStatus AsyncReader::tryNext(Value& v)
+{
+    for(;;)
+    {
+        if(pos < end)
+        {
+            const PushParser::Progress p = parser.feed(buffer.data() + pos, end - pos);
+            pos += p.consumed;
+            mid_document = p.status == PushParser::NeedMore;
+            if(p.status == PushParser::Complete)
+            {
+                v = parser.take();
+                return IoStatus::Ready;
+            }
+            if(p.status == PushParser::Error)
+                return fail(parser.getLastError());
+        }
+
+        const ssize_t got = ::read(file, buffer.data(), buffer.size());
+        if(got > 0)
+        {
+            pos = 0;
+            end = static_cast<std::size_t>(got);
+            continue;
+        }
+        if(got == 0)
+            return mid_document ? fail(describeError(ParseError::UnexpectedEnd)) : IoStatus::Closed;
+        if(errno == EAGAIN or errno == EWOULDBLOCK)
+            return IoStatus::WouldBlock;
+        if(errno != EINTR)
+            return fail(std::strerror(errno));
+    }
+}
+
+void AsyncReader::next(Value& v, std::function<void(IoStatus)> done)
+{
+    const IoStatus status = tryNext(v);
+    if(status == IoStatus::WouldBlock)
+        wait(v, std::move(done));
+    else
+        loop.post([done, status]{ done(status); });
+}
+
+//! reads the next document into \a v once fd is readable, for as many wake ups as it takes
+void AsyncReader::wait(Value& v, std::function<void(IoStatus)> done)
+{
+    loop.whenReadable(file, [this, &v, done]{
+        const IoStatus status = tryNext(v);
+        if(status == IoStatus::WouldBlock)
+            wait(v, done);
+        else
+            done(status);
+    });
+}
+
+IoStatus AsyncReader::fail(std::string error)
+{
+    last_error = std::move(error);
+    return IoStatus::Error;
+}
+
+
+AsyncWriter::AsyncWriter(EventLoop& Loop, int fd, StreamWriterOptions Options)
+    : loop(Loop), file(fd), options(Options)
+{
+}
+
+bool AsyncWriter::queue(const Value& v)
+{
+    Queue q{out};
+    StreamWriter<Queue> writer(q, options);
+    if(writer.writeValue(v).second)
+        return true;
+    last_error = "Only Objects can be written";
+    return false;
+}
+
+IoStatus AsyncWriter::tryWrite(const Value& v)
+{
+    if(not queue(v))
+        return IoStatus::Error;
+    return flush();
+}
+
+IoStatus AsyncWriter::flush()
+{
+    while(sent < out.size())
+    {
+        //sockets whose peer has gone fail with EPIPE rather than raising SIGPIPE
+        ssize_t n = ::send(file, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if(n < 0 and errno == ENOTSOCK)
+            n = ::write(file, out.data() + sent, out.size() - sent);
+        if(n >= 0)
+        {
+            sent += static_cast<std::size_t>(n);
+            continue;
+        }
+        if(errno == EAGAIN or errno == EWOULDBLOCK)
+        {
+            //the sent bytes are dropped once they are the bulk of the queue, so it doesn't grow without end
+            if(sent > out.size() / 2)
+            {
+                out.erase(0, sent);
+                sent = 0;
+            }
+            return IoStatus::WouldBlock;
+        }
+        if(errno != EINTR)
+        {
+            last_error = std::strerror(errno);
+            return errno == EPIPE ? IoStatus::Closed : IoStatus::Error;
+        }
+    }
+    out.clear();
+    sent = 0;
+    return IoStatus::Ready;
+}
+
+void AsyncWriter::write(const Value& v, std::function<void(IoStatus)> done)
+{
+    const IoStatus status = tryWrite(v);
+    if(status == IoStatus::WouldBlock)
+        wait(std::move(done));
+    else
+        loop.post([done, status]{ done(status); });
+}
+
+//! flushes the queue each time fd is writable, until it is empty or the fd fails
+void AsyncWriter::wait(std::function<void(IoStatus)> done)
+{
+    loop.whenWritable(file, [this, done]{
+        const IoStatus status = flush();
+        if(status == IoStatus::WouldBlock)
+            wait(done);
+        else
+            done(status);
+    });
+}
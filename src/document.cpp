@@ -0,0 +1,286 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "document.hpp"
+#include "shadowed_keys.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace timl;
+
+std::size_t ValueView::size() const noexcept
+{
+    switch (vtype) {
+    case Type::Null:
+        return 0;
+    case Type::Map:
+    case Type::Array:
+        return count;
+    default:
+        return 1;
+    }
+}
+
+StringRef ValueView::str() const noexcept
+{
+    return isString() ? StringRef(chars, count) : StringRef();
+}
+
+ByteSpan ValueView::bytes() const noexcept
+{
+    return isBinary() ? ByteSpan(reinterpret_cast<const byte*>(chars), count) : ByteSpan();
+}
+
+const ValueView& ValueView::operator [] (int i) const
+{
+    if(vtype != Type::Array)
+        throw value_exception("Attempt to index 'ValueView'; 'ValueView' is not an Array!");
+    if(i < 0 or static_cast<std::size_t>(i) >= count)
+        throw std::out_of_range("ValueView: Array index out of range");
+    return items[i];
+}
+
+const ValueView* ValueView::find(StringRef key) const noexcept
+{
+    if(vtype != Type::Map)
+        return nullptr;
+    for(std::size_t i = count; i > 0; --i)
+        if(items[i - 1].item_key == key)
+            return &items[i - 1];
+    return nullptr;
+}
+
+const ValueView& ValueView::operator [] (const std::string& key) const
+{
+    if(vtype != Type::Map)
+        throw value_exception("Attempt to index 'ValueView'; 'ValueView' is not a Key-Value pair (aka Object) !");
+    const ValueView* it = find(StringRef(key));
+    if(not it)
+        throw std::out_of_range("ValueView: no such key");
+    return *it;
+}
+
+const ValueView& ValueView::operator [] (const char* key) const
+{ return operator [] (std::string(key)); }
+
+bool ValueView::contains(StringRef key) const noexcept
+{ return find(key) != nullptr; }
+
+Value::Keys ValueView::keys() const
+{
+    Value::Keys rtn;
+    if(vtype != Type::Map)
+        return rtn;
+    rtn.reserve(count);
+    for(const ValueView& item : *this)
+        rtn.push_back(item.item_key.str());
+    return rtn;
+}
+
+Value ValueView::toValue() const
+{
+    switch (vtype) {
+    case Type::Bool:        return Value(Bool);
+    case Type::Char:        return Value(Char);
+    case Type::SignedInt:   return Value(SignedInt);
+    case Type::UnsignedInt: return Value(UnsignedInt);
+    case Type::Float:       return Value(Float);
+    case Type::String:      return Value(std::string(chars, count));
+    case Type::Binary:      return Value(Value::BinaryType(chars, chars + count));
+    case Type::Map:
+    {
+        Value rtn;
+        rtn.reserve(count);
+        for(const ValueView& item : *this)
+            rtn.emplace(item.item_key.str(), item.toValue());
+        return rtn;
+    }
+    case Type::Array:
+    {
+        Value rtn;
+        for(const ValueView& item : *this)
+            rtn.emplace_back(item.toValue());
+        return rtn;
+    }
+    default:
+        return Value();
+    }
+}
+
+
+Document::Document(std::size_t block_size)
+    : first_block(block_size)
+{
+    blocks.push_back(Block{std::unique_ptr<byte[]>(new byte[block_size]), block_size});
+}
+
+Document::Document(Document&& other) noexcept
+    : blocks(std::move(other.blocks)), first_block(other.first_block), used(other.used), retired(other.retired),
+      top(other.top), pending(std::move(other.pending)), open_at(std::move(other.open_at))
+{
+    other.blocks.clear();
+    other.clear();
+}
+
+Document& Document::operator = (Document&& other) noexcept
+{
+    if(this != &other)
+    {
+        blocks = std::move(other.blocks);
+        first_block = other.first_block;
+        used = other.used;
+        retired = other.retired;
+        top = other.top;
+        pending = std::move(other.pending);
+        open_at = std::move(other.open_at);
+        other.blocks.clear();
+        other.clear();
+    }
+    return *this;
+}
+
+void Document::clear() noexcept
+{
+    //a document that outgrew the first block gets one as large as all of them, on the next allocation
+    if(blocks.size() > 1)
+    {
+        std::size_t total = 0;
+        for(const Block& b : blocks)
+            total += b.size;
+        blocks.clear();
+        blocks.push_back(Block{nullptr, total});
+    }
+    used = 0;
+    retired = 0;
+    top = ValueView();
+    pending.clear();
+    open_at.clear();
+}
+
+std::size_t Document::bytesUsed() const noexcept
+{
+    return retired + used;
+}
+
+std::size_t Document::bytesReserved() const noexcept
+{
+    std::size_t total = 0;
+    for(const Block& b : blocks)
+        total += b.bytes ? b.size : 0;
+    return total;
+}
+
+void* Document::allocate(std::size_t size)
+{
+    //rounded up, so that every allocation stays aligned for a ValueView
+    size = (size + alignof(ValueView) - 1) / alignof(ValueView) * alignof(ValueView);
+
+    if(blocks.empty())      //moved from
+        blocks.push_back(Block{nullptr, first_block});
+
+    Block& last = blocks.back();
+    if(not last.bytes and size <= last.size)
+        last.bytes.reset(new byte[last.size]);
+    else if(not last.bytes or last.size - used < size)
+    {
+        const std::size_t grown = std::max(size, 2 * last.size);
+        retired += used;
+        blocks.push_back(Block{std::unique_ptr<byte[]>(new byte[grown]), grown});
+        used = 0;
+    }
+
+    byte* p = blocks.back().bytes.get() + used;
+    used += size;
+    return p;
+}
+
+
+DocumentBuilder::DocumentBuilder(Document& document)
+    : doc(document)
+{
+    doc.clear();
+}
+
+//! appends \a v to the container being built, or makes it the root
+void DocumentBuilder::put(ValueView v)
+{
+    if(doc.open_at.empty())
+    {
+        doc.top = v;
+        return;
+    }
+    if(doc.pending[doc.open_at.back()].vtype == Type::Map)
+        v.item_key = pending_key;
+    doc.pending.push_back(v);
+}
+
+void DocumentBuilder::sequence(Type type, const char* data, std::size_t size)
+{
+    ValueView v;
+    v.vtype = type;
+    v.chars = copy(data, size);
+    v.count = size;
+    put(v);
+}
+
+const char* DocumentBuilder::copy(const char* data, std::size_t size)
+{
+    if(size == 0)
+        return "";
+    char* p = static_cast<char*>(doc.allocate(size));
+    std::memcpy(p, data, size);
+    return p;
+}
+
+//! the container stands in pending ahead of its items, until they are complete
+void DocumentBuilder::open(Type type)
+{
+    ValueView v;
+    v.vtype = type;
+    if(not doc.open_at.empty() and doc.pending[doc.open_at.back()].vtype == Type::Map)
+        v.item_key = pending_key;
+    doc.open_at.push_back(doc.pending.size());
+    doc.pending.push_back(v);
+}
+
+//! copies the items of the innermost container next to each other, then puts the container itself
+void DocumentBuilder::close()
+{
+    const std::size_t at = doc.open_at.back();
+    doc.open_at.pop_back();
+
+    ValueView v = doc.pending[at];
+    if(v.vtype == Type::Map)
+    {
+        const std::size_t kept = dropShadowed(doc.pending.data() + at + 1, doc.pending.size() - at - 1, doc.order,
+                                              [](const ValueView& item) { return item.item_key; });
+        doc.pending.resize(at + 1 + kept);
+    }
+    v.count = doc.pending.size() - at - 1;
+    if(v.count == 0)
+        v.vtype = Type::Null;
+    else
+    {
+        ValueView* items = static_cast<ValueView*>(doc.allocate(v.count * sizeof(ValueView)));
+        std::copy(doc.pending.begin() + at + 1, doc.pending.end(), items);
+        v.items = items;
+    }
+    doc.pending.resize(at);
+
+    if(doc.open_at.empty())
+        doc.top = v;
+    else
+        doc.pending.push_back(v);
+}
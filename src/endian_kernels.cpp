@@ -0,0 +1,184 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "endian_kernels.hpp"
+#include "stream_helpers.hpp"
+#include <initializer_list>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TIML_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace timl;
+
+namespace {
+
+    //! converts one item at a time; also finishes what the vector kernels leave over
+    template<std::size_t Size>
+    void swap_scalar(const byte* src, std::size_t n, byte* dst)
+    {
+        using U = typename uint_of_size<Size>::type;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            U v;
+            std::memcpy(&v, src + i * Size, Size);
+            v = fromBigEndian(v);
+            std::memcpy(dst + i * Size, &v, Size);
+        }
+    }
+
+#ifdef TIML_X86_KERNELS
+
+    /*!
+     * the byte order pshufb reverses each Size byte item with, for 64 bytes;
+     * it indexes within each 16 byte lane, so narrower vectors load a prefix of it
+     */
+    template<std::size_t Size>
+    struct SwapMask
+    {
+        byte order[64];
+        SwapMask()
+        {
+            for(std::size_t i = 0; i < sizeof(order); ++i)
+                order[i] = static_cast<byte>((i % 16) / Size * Size + Size - 1 - i % Size);
+        }
+    };
+
+    template<std::size_t Size>
+    const byte* swap_mask()
+    {
+        static const SwapMask<Size> mask;
+        return mask.order;
+    }
+
+    //! SSE2 has no byte shuffle: bytes are swapped within 16 bit words, then the words are reordered
+    template<std::size_t Size>
+    __attribute__((target("sse2")))
+    void swap_sse2(const byte* src, std::size_t n, byte* dst)
+    {
+        const std::size_t bytes = n * Size, vectors = bytes / 16;
+        for(std::size_t i = 0; i < vectors; ++i)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            if(Size == 4)
+            {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            }
+            else if(Size == 8)
+            {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 16), v);
+        }
+        const std::size_t done = vectors * 16 / Size;
+        swap_scalar<Size>(src + done * Size, n - done, dst + done * Size);
+    }
+
+    template<std::size_t Size>
+    __attribute__((target("ssse3")))
+    void swap_ssse3(const byte* src, std::size_t n, byte* dst)
+    {
+        const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(swap_mask<Size>()));
+        const std::size_t bytes = n * Size, vectors = bytes / 16;
+        for(std::size_t i = 0; i < vectors; ++i)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 16), _mm_shuffle_epi8(v, mask));
+        }
+        const std::size_t done = vectors * 16 / Size;
+        swap_scalar<Size>(src + done * Size, n - done, dst + done * Size);
+    }
+
+    template<std::size_t Size>
+    __attribute__((target("avx2")))
+    void swap_avx2(const byte* src, std::size_t n, byte* dst)
+    {
+        const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(swap_mask<Size>()));
+        const std::size_t bytes = n * Size, vectors = bytes / 32;
+        for(std::size_t i = 0; i < vectors; ++i)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 32), _mm256_shuffle_epi8(v, mask));
+        }
+        const std::size_t done = vectors * 32 / Size;
+        swap_ssse3<Size>(src + done * Size, n - done, dst + done * Size);
+    }
+
+    template<std::size_t Size>
+    __attribute__((target("avx512f,avx512bw")))
+    void swap_avx512(const byte* src, std::size_t n, byte* dst)
+    {
+        const __m512i mask = _mm512_loadu_si512(swap_mask<Size>());
+        const std::size_t bytes = n * Size, vectors = bytes / 64;
+        for(std::size_t i = 0; i < vectors; ++i)
+        {
+            const __m512i v = _mm512_loadu_si512(src + i * 64);
+            _mm512_storeu_si512(dst + i * 64, _mm512_shuffle_epi8(v, mask));
+        }
+        const std::size_t done = vectors * 64 / Size;
+        swap_avx2<Size>(src + done * Size, n - done, dst + done * Size);
+    }
+
+#endif
+
+    const EndianKernels scalar_kernels{EndianIsa::Scalar, "scalar", swap_scalar<2>, swap_scalar<4>, swap_scalar<8>};
+#ifdef TIML_X86_KERNELS
+    const EndianKernels sse2_kernels{EndianIsa::SSE2, "sse2", swap_sse2<2>, swap_sse2<4>, swap_sse2<8>};
+    const EndianKernels ssse3_kernels{EndianIsa::SSSE3, "ssse3", swap_ssse3<2>, swap_ssse3<4>, swap_ssse3<8>};
+    const EndianKernels avx2_kernels{EndianIsa::AVX2, "avx2", swap_avx2<2>, swap_avx2<4>, swap_avx2<8>};
+    const EndianKernels avx512_kernels{EndianIsa::AVX512, "avx512", swap_avx512<2>, swap_avx512<4>, swap_avx512<8>};
+#endif
+
+    const EndianKernels& best_kernels() noexcept
+    {
+        for(EndianIsa isa : {EndianIsa::AVX512, EndianIsa::AVX2, EndianIsa::SSSE3, EndianIsa::SSE2})
+            if(const EndianKernels* k = endianKernels(isa))
+                return *k;
+        return scalar_kernels;
+    }
+
+}
+
+const EndianKernels& timl::endianKernels() noexcept
+{
+    static const EndianKernels& best = best_kernels();
+    return best;
+}
+
+const EndianKernels* timl::endianKernels(EndianIsa isa) noexcept
+{
+#ifdef TIML_X86_KERNELS
+    //also checks that the OS saves the wider registers across context switches
+    __builtin_cpu_init();
+    switch (isa) {
+    case EndianIsa::Scalar:
+        return &scalar_kernels;
+    case EndianIsa::SSE2:
+        return &sse2_kernels;
+    case EndianIsa::SSSE3:
+        return __builtin_cpu_supports("ssse3") ? &ssse3_kernels : nullptr;
+    case EndianIsa::AVX2:
+        return __builtin_cpu_supports("avx2") ? &avx2_kernels : nullptr;
+    case EndianIsa::AVX512:
+        return __builtin_cpu_supports("avx512bw") ? &avx512_kernels : nullptr;
+    }
+    return nullptr;
+#else
+    return isa == EndianIsa::Scalar ? &scalar_kernels : nullptr;
+#endif
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "event_handler.hpp"
+#include <algorithm>
+#include <iterator>
+
+using namespace timl;
+
+void ValueRecycler::string(StringRef s)
+{
+    Value& v = slot();
+    if(v.vtype == Type::String)
+        v.value.String.assign(s.data(), s.size());
+    else
+        v = Value(s.str());
+}
+
+void ValueRecycler::binary(ByteSpan b)
+{
+    Value& v = slot();
+    if(v.vtype == Type::Binary)
+        v.value.Binary.assign(b.begin(), b.end());
+    else
+        v = Value(Value::BinaryType(b.begin(), b.end()));
+}
+
+Value& ValueRecycler::slot()
+{
+    if(stack.empty())
+        return *root;
+
+    Frame& top = stack.back();
+    Value& container = *top.value;
+    Value* item = nullptr;
+    if(top.type == Type::Map)
+    {
+        if(container.vtype == Type::Map)
+        {
+            auto found = container.value.Map.find(Key::borrow(pending_key));
+            if(found != container.value.Map.end())
+                item = found->second.get();
+        }
+        if(not item)
+            item = &container.emplace(key_table ? key_table->intern(StringRef(pending_key)) : Key(pending_key), Value());
+        stored.push_back(item);
+    }
+    else
+    {
+        if(container.vtype == Type::Array and top.filled < container.value.Array.size())
+            item = container.value.Array[top.filled].get();
+        else
+            item = &container.emplace_back(Value());
+        ++top.filled;
+    }
+
+    //Until its first item, a new container is still Null and has no storage to reserve
+    if(top.reserve > 1)
+        container.reserve(top.reserve);
+    top.reserve = 0;
+    return *item;
+}
+
+//! a container of the right type is kept, items and all; anything else starts over as Null
+void ValueRecycler::open(Type type, std::size_t reserve)
+{
+    Value& v = slot();
+    if(v.vtype != type)
+        v = Value();
+    else
+        reserve = 0;    //reserving again could shrink the room it already has
+    stack.push_back(Frame{&v, type, 0, stored.size(), reserve});
+}
+
+//! drops the items the container held that the document didn't refill
+void ValueRecycler::close()
+{
+    const Frame top = stack.back();
+    stack.pop_back();
+    Value& container = *top.value;
+
+    if(container.vtype == Type::Array and top.filled < container.value.Array.size())
+        container.value.Array.resize(top.filled);
+    else if(container.vtype == Type::Map)
+    {
+        //a key repeated in the document refills the same item twice
+        const auto first = stored.begin() + top.stored_from;
+        std::sort(first, stored.end());
+        const auto last = std::unique(first, stored.end());
+
+        Value::MapType& map = container.value.Map;
+        if(static_cast<std::size_t>(last - first) != map.size())
+            for(auto it = map.begin(); it != map.end();)
+                it = std::binary_search(first, last, it->second.get()) ? std::next(it) : map.erase(it);
+    }
+    stored.resize(top.stored_from);
+
+    //an empty container is Null, just like an empty Value
+    if(container.size() == 0)
+        container = Value();
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "key_table.hpp"
+
+using namespace timl;
+
+KeyTable::KeyTable(bool ThreadSafe, std::size_t MaxKeys)
+    : thread_safe(ThreadSafe), max_keys(MaxKeys)
+{
+}
+
+KeyTable::~KeyTable()
+{
+    //the Keys still sharing an atom keep it alive
+    for(auto& a : atoms)
+        Key dropped(a.second);
+}
+
+Key KeyTable::intern(StringRef k)
+{
+    if(not thread_safe)
+        return find_or_add(k);
+    std::lock_guard<std::mutex> lock(mutex);
+    return find_or_add(k);
+}
+
+std::size_t KeyTable::size() const
+{
+    if(not thread_safe)
+        return atoms.size();
+    std::lock_guard<std::mutex> lock(mutex);
+    return atoms.size();
+}
+
+//! \pre the mutex is held, for thread safe tables
+Key KeyTable::find_or_add(StringRef text)
+{
+    //Maps hash owned Keys just as std::string is, interned ones have to agree
+    scratch.assign(text.data(), text.size());
+    const Probe k{text, std::hash<std::string>()(scratch)};
+
+    auto found = atoms.find(k);
+    if(found != atoms.end())
+    {
+        found->second->refs.fetch_add(1, std::memory_order_relaxed);
+        return Key(found->second);
+    }
+    if(atoms.size() >= max_keys)
+        return Key(scratch);
+
+    //one reference for the table, one for the Key handed out
+    Key::Atom* atom = new Key::Atom{{2}, k.hash, scratch};
+    atoms.emplace(Probe{StringRef(atom->text), k.hash}, atom);
+    return Key(atom);
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "lazy_value.hpp"
+#include "event_handler.hpp"
+#include "shadowed_keys.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace timl;
+
+LazyValue::LazyValue(ByteSpan document, ValueSizePolicy policy)
+    : encoded(document), payload(1), marker(0), vsz(policy)
+{
+    if(document.empty() or not isObjectStart(document[0]))
+        throw parsing_exception(ParseError::NotAnObject);
+    marker = document[0];
+    encoded = document.subspan(0, payload + scan());
+}
+
+LazyValue::LazyValue(ByteSpan Encoded, std::size_t Payload, byte Marker, const ValueSizePolicy& policy)
+    : encoded(Encoded), payload(Payload), marker(Marker), vsz(policy)
+{
+    if(isObjectStart(marker) or isHetroArrayStart(marker) or isHomoArrayStart(marker))
+        scan();
+    else
+        vtype = value().type();
+}
+
+LazyValue::~LazyValue() = default;
+
+/*!
+ * records where each item of the container starts and ends, skipping over their payloads
+ * \return the size of the container's payload
+ */
+std::size_t LazyValue::scan()
+{
+    ByteSpan span = encoded.subspan(payload);
+    BufferReader reader(span, vsz);
+    reader.begin_value();
+
+    std::size_t rest;
+    ContainerFrame f = reader.extract_containerHeader(marker, rest);
+    //A count is only a claim, each item takes at least a byte
+    items.reserve(std::min(f.remaining, span.size()));
+    vtype = f.remaining == 0 ? Type::Null : (f.type == MarkerType::Object ? Type::Map : Type::Array);
+
+    while(f.remaining > 0)
+    {
+        --f.remaining;
+        Item it{StringRef(), ByteSpan(), 0, f.type_mark, nullptr};
+        if(f.type == MarkerType::Object)
+            it.key = reader.extract_Key().first;
+
+        const std::size_t start = reader.getBytesRead();
+        if(f.type != MarkerType::HomoArray)
+            reader.read(it.marker);
+        it.payload = reader.getBytesRead() - start;
+        reader.skip_value(it.marker);
+        it.encoded = span.subspan(start, reader.getBytesRead() - start);
+        items.push_back(std::move(it));
+    }
+
+    if(not f.end_consumed)
+        reader.validate_container_end(f.type);
+
+    if(vtype == Type::Map)
+    {
+        std::vector<std::size_t> order;
+        items.resize(dropShadowed(items.data(), items.size(), order, [](const Item& it) { return it.key; }));
+    }
+    return reader.getBytesRead();
+}
+
+std::size_t LazyValue::size() const noexcept
+{
+    switch (vtype) {
+    case Type::Null:
+        return 0;
+    case Type::Array:
+    case Type::Map:
+        return items.size();
+    default:
+        return 1;
+    }
+}
+
+const LazyValue& LazyValue::item(std::size_t i) const
+{
+    const Item& it = items[i];
+    if(not it.value)
+        it.value.reset(new LazyValue(it.encoded, it.payload, it.marker, vsz));
+    return *it.value;
+}
+
+const LazyValue::Item* LazyValue::find(StringRef key) const noexcept
+{
+    if(vtype != Type::Map)
+        return nullptr;
+    for(auto it = items.rbegin(); it != items.rend(); ++it)
+        if(it->key == key)
+            return &*it;
+    return nullptr;
+}
+
+const LazyValue& LazyValue::operator [] (int i) const
+{
+    if(vtype != Type::Array)
+        throw value_exception("Attempt to index 'LazyValue'; 'LazyValue' is not an Array!");
+    if(i < 0 or static_cast<std::size_t>(i) >= items.size())
+        throw std::out_of_range("LazyValue: Array index out of range");
+    return item(static_cast<std::size_t>(i));
+}
+
+const LazyValue& LazyValue::member(StringRef key) const
+{
+    if(vtype != Type::Map)
+        throw value_exception("Attempt to index 'LazyValue'; 'LazyValue' is not a Key-Value pair (aka Object) !");
+    const Item* it = find(key);
+    if(not it)
+        throw std::out_of_range("LazyValue: no such key");
+    return item(static_cast<std::size_t>(it - items.data()));
+}
+
+const LazyValue& LazyValue::operator [] (const std::string& key) const
+{ return member(StringRef(key)); }
+
+const LazyValue& LazyValue::operator [] (const char* key) const
+{ return member(StringRef(key)); }
+
+bool LazyValue::contains(StringRef key) const noexcept
+{ return find(key) != nullptr; }
+
+Value::Keys LazyValue::keys() const
+{
+    Value::Keys rtn;
+    if(vtype != Type::Map)
+        return rtn;
+    rtn.reserve(items.size());
+    for(const auto& it : items)
+        rtn.push_back(it.key.str());
+    return rtn;
+}
+
+LazyValue::const_iterator LazyValue::begin() const
+{ return const_iterator(this, 0); }
+
+LazyValue::const_iterator LazyValue::end() const
+{ return const_iterator(this, items.size()); }
+
+const Value& LazyValue::value() const
+{
+    if(decoded)
+        return *decoded;
+
+    std::unique_ptr<Value> v(new Value());
+    ByteSpan span = encoded.subspan(payload);
+    BufferReader reader(span, vsz);
+    reader.begin_value();
+    ValueBuilder builder(*v, vsz);
+    if(not reader.extract_singleValueTo(marker, builder))
+        reader.extract_containerValueTo(marker, builder);
+    decoded = std::move(v);
+    return *decoded;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "parallel_document_reader.hpp"
+#include <algorithm>
+
+using namespace timl;
+
+namespace {
+
+    //! a batch is closed once it holds this many documents, or bytes
+    const std::size_t batch_documents = 16;
+    const std::size_t batch_bytes = 64 * 1024;
+
+}
+
+ParallelDocumentReader::ParallelDocumentReader(ByteSpan documents, ParallelReaderOptions options, ValueSizePolicy policy)
+    : bytes(documents), vsz(policy), ordered(options.ordered),
+      max_batches(4 * std::max<std::size_t>(1, options.threads ? options.threads : std::thread::hardware_concurrency()))
+{
+    const std::size_t count = max_batches / 4;
+    workers.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+        workers.emplace_back(&ParallelDocumentReader::decode, this);
+    scanner = std::thread(&ParallelDocumentReader::scan, this);
+}
+
+ParallelDocumentReader::~ParallelDocumentReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobs_cv.notify_all();
+    room_cv.notify_all();
+    scanner.join();
+    for(auto& worker : workers)
+        worker.join();
+}
+
+//! steps over each document to find where it ends, and queues them in batches
+void ParallelDocumentReader::scan()
+{
+    ByteSpan rest = bytes;
+    BufferReader reader(rest, vsz);
+    std::size_t offset = 0;
+    std::string error;
+    std::unique_ptr<Batch> batch;
+
+    while(true)
+    {
+        const bool at_end = reader.atEnd();
+        if(not at_end and error.empty())
+        {
+            if(reader.skipNextValue())
+            {
+                if(not batch)
+                {
+                    batch.reset(new Batch());
+                    batch->bytes = bytes.subspan(offset, 0);
+                }
+                //a batch's documents are consecutive, so it only grows its span
+                offset += reader.getBytesRead();
+                batch->bytes = ByteSpan(batch->bytes.data(), batch->bytes.size() + reader.getBytesRead());
+                ++batch->count;
+                if(batch->count < batch_documents and batch->bytes.size() < batch_bytes)
+                    continue;
+            }
+            else
+                error = reader.getLastError();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if(batch)
+        {
+            room_cv.wait(lock, [this]{ return stopping or in_flight < max_batches; });
+            if(stopping)
+                return;
+            batch->seq = scanned++;
+            ++in_flight;
+            jobs.push_back(std::move(batch));
+            jobs_cv.notify_one();
+        }
+        if(at_end or not error.empty())
+        {
+            scan_error = error;
+            scan_done = true;
+            done_cv.notify_all();
+            jobs_cv.notify_all();
+            return;
+        }
+    }
+}
+
+//! decodes queued batches until scanning is over and none are left, or the reader is stopping
+void ParallelDocumentReader::decode()
+{
+    while(true)
+    {
+        std::unique_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobs_cv.wait(lock, [this]{ return stopping or not jobs.empty() or scan_done; });
+            if(stopping or jobs.empty())
+                return;
+            batch = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        batch->values.reserve(batch->count);
+        ByteSpan documents = batch->bytes;
+        BufferReader reader(documents, vsz);
+        for(std::size_t i = 0; i < batch->count; ++i)
+        {
+            Value v;
+            if(not reader.getNextValue(v))
+            {
+                batch->error = reader.getLastError();
+                break;
+            }
+            batch->values.push_back(std::move(v));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const std::size_t seq = batch->seq;
+            decoded[seq] = std::move(batch);
+        }
+        done_cv.notify_all();
+    }
+}
+
+//! the next batch for next() to hand out, or nullptr once there are none left
+std::unique_ptr<ParallelDocumentReader::Batch> ParallelDocumentReader::wait_for_batch()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        auto it = ordered ? decoded.find(next_seq) : decoded.begin();
+        if(it != decoded.end())
+        {
+            std::unique_ptr<Batch> batch = std::move(it->second);
+            decoded.erase(it);
+            ++next_seq;
+            return batch;
+        }
+        if(scan_done and next_seq == scanned)
+        {
+            last_error = scan_error;
+            return nullptr;
+        }
+        done_cv.wait(lock);
+    }
+}
+
+bool ParallelDocumentReader::next(Value& v)
+{
+    while(not finished)
+    {
+        if(current and current->taken < current->values.size())
+        {
+            v = std::move(current->values[current->taken++]);
+            return true;
+        }
+
+        if(current)
+        {
+            if(not current->error.empty())
+            {
+                last_error = current->error;
+                finished = true;
+                break;
+            }
+            current.reset();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --in_flight;
+            }
+            room_cv.notify_one();
+        }
+
+        current = wait_for_batch();
+        if(not current)
+            finished = true;
+    }
+    return false;
+}
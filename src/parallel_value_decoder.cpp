@@ -0,0 +1,219 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "parallel_value_decoder.hpp"
+#include "event_handler.hpp"
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+using namespace timl;
+
+namespace {
+
+    //! an Array is split into this many chunks per thread, so a thread done early takes on another one
+    const std::size_t chunks_per_thread = 4;
+
+    //! whether every item of a HomoArray of \a type_mark takes the same number of bytes
+    bool fixed_width(byte type_mark)
+    {
+        switch (markerInfo(type_mark).kind) {
+        case MarkerKind::String:
+        case MarkerKind::Binary:
+        case MarkerKind::Object:
+        case MarkerKind::HetroArray:
+        case MarkerKind::HomoArray:
+        case MarkerKind::Invalid:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    //! \a policy, for values nested \a levels deeper than the document they are part of
+    ValueSizePolicy nested_policy(ValueSizePolicy policy, std::size_t levels)
+    {
+        policy.max_value_depth = policy.max_value_depth > levels ? policy.max_value_depth - levels : 0;
+        return policy;
+    }
+
+}
+
+ParallelValueDecoder::ParallelValueDecoder(ParallelDecodeOptions options, ValueSizePolicy policy)
+    : thread_count(std::max<std::size_t>(1, options.threads ? options.threads : std::thread::hardware_concurrency())),
+      min_items(options.min_items), vsz(policy), member_vsz(nested_policy(policy, 1)), item_vsz(nested_policy(policy, 2))
+{
+}
+
+bool ParallelValueDecoder::decode(ByteSpan document, Value& v)
+{
+    bytes_read = 0;
+    try
+    {
+        ByteSpan span = document;
+        BufferReader reader(span, member_vsz);
+        reader.begin_value();
+
+        byte marker;
+        reader.read(marker);
+        if(not isObjectStart(marker))
+            throw parsing_exception(ParseError::NotAnObject);
+        std::size_t rest;
+        ContainerFrame f = reader.extract_containerHeader(marker, rest);
+        if(not f.end_consumed and vsz.max_value_depth == 0)
+            throw parsing_exception(ParseError::TooDeep);
+
+        Value root;
+        while(f.remaining > 0)
+        {
+            --f.remaining;
+            std::string key = reader.extract_Key().first.str();
+            reader.read(marker);
+            Value& member = root.emplace(std::move(key), Value());
+            if(decode_array(reader, document, marker, member))
+                continue;
+
+            ValueBuilder builder(member, member_vsz);
+            if(not reader.extract_singleValueTo(marker, builder))
+                reader.extract_containerValueTo(marker, builder);
+        }
+        if(not f.end_consumed)
+            reader.validate_container_end(f.type);
+
+        bytes_read = reader.getBytesRead();
+        v = std::move(root);
+        return true;
+    }
+    catch(parsing_exception& pexecpt)
+    {
+        last_error = pexecpt.what();
+    }
+    return false;
+}
+
+/*!
+ * decodes the Array introduced by \a marker on the threads, if it holds at least min_items
+ * \return false, having read nothing, for every other value
+ */
+bool ParallelValueDecoder::decode_array(BufferReader& reader, ByteSpan document, byte marker, Value& v)
+{
+    if(thread_count < 2 or not (isHetroArrayStart(marker) or isHomoArrayStart(marker)))
+        return false;
+
+    //the count is peeked at, so an Array that stays on this thread is decoded as a whole, bulk numbers included
+    ByteSpan header = document.subspan(reader.getBytesRead());
+    BufferReader peek(header, member_vsz);
+    std::size_t rest;
+    if(peek.extract_containerHeader(marker, rest).remaining < std::max<std::size_t>(min_items, 1))
+        return false;
+
+    const ContainerFrame f = reader.extract_containerHeader(marker, rest);
+    if(member_vsz.max_value_depth == 0)
+        throw parsing_exception(ParseError::TooDeep);
+    std::vector<Chunk> chunks = split_array(reader, document, f);
+
+    std::atomic<std::size_t> next_chunk{0};
+    auto work = [this, &chunks, &next_chunk]
+    {
+        for(std::size_t i; (i = next_chunk++) < chunks.size(); )
+            decode_chunk(chunks[i]);
+    };
+    std::vector<std::thread> helpers;
+    const std::size_t helper_count = std::min(thread_count, chunks.size()) - 1;
+    helpers.reserve(helper_count);
+    for(std::size_t i = 0; i < helper_count; ++i)
+        helpers.emplace_back(work);
+    work();
+    for(auto& helper : helpers)
+        helper.join();
+
+    for(Chunk& chunk : chunks)
+    {
+        if(not chunk.error.empty())
+            throw parsing_exception(chunk.error.c_str(), chunk.code);
+        if(v.isNull())
+        {
+            v = std::move(chunk.items);
+            v.reserve(f.remaining);
+        }
+        else
+            v.append(std::move(chunk.items));
+    }
+    return true;
+}
+
+/*!
+ * steps over the items of the Array \a f, whose header was just read, recording where each chunk of them
+ * starts and ends; the items of a HomoArray of fixed size markers are not even looked at
+ */
+std::vector<ParallelValueDecoder::Chunk>
+ParallelValueDecoder::split_array(BufferReader& reader, ByteSpan document, const ContainerFrame& f)
+{
+    const std::size_t chunk_count = thread_count * chunks_per_thread;
+    const std::size_t chunk_items = (f.remaining + chunk_count - 1) / chunk_count;
+    const bool shared_mark = f.type == MarkerType::HomoArray;
+    const byte type_mark = f.type_mark;
+    if(shared_mark and f.remaining > 0 and markerInfo(type_mark).kind == MarkerKind::Invalid)
+        throw parsing_exception(ParseError::UnknownMarker);
+    const bool fixed = shared_mark and fixed_width(type_mark);
+
+    std::vector<Chunk> chunks;
+    chunks.reserve(chunk_count);
+    for(std::size_t done = 0; done < f.remaining; )
+    {
+        const std::size_t count = std::min(chunk_items, f.remaining - done);
+        const std::size_t start = reader.getBytesRead();
+        if(fixed)
+            reader.skip_bytes(count * markerInfo(type_mark).width);
+        else
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                byte m = type_mark;
+                if(not shared_mark)
+                    reader.read(m);
+                reader.skip_value(m);
+            }
+        chunks.push_back(Chunk{document.subspan(start, reader.getBytesRead() - start), count, shared_mark, type_mark, Value(), std::string(), ParseError::None});
+        done += count;
+    }
+    reader.validate_container_end(f.type);
+    return chunks;
+}
+
+//! decodes the items of \a chunk into an Array, or records why they could not be
+void ParallelValueDecoder::decode_chunk(Chunk& chunk) const
+{
+    try
+    {
+        ByteSpan span = chunk.bytes;
+        BufferReader reader(span, item_vsz);
+        reader.begin_value();
+        ValueBuilder builder(chunk.items, item_vsz);
+        builder.startArray(chunk.count);
+        for(std::size_t i = 0; i < chunk.count; ++i)
+        {
+            byte m = chunk.type_mark;
+            if(not chunk.shared_mark)
+                reader.read(m);
+            if(not reader.extract_singleValueTo(m, builder))
+                reader.extract_containerValueTo(m, builder);
+        }
+        builder.endArray();
+    }
+    catch(parsing_exception& pexecpt)
+    {
+        chunk.error = pexecpt.what();
+        chunk.code = pexecpt.code();
+    }
+}
@@ -0,0 +1,434 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "push_parser.hpp"
+#include "stream_helpers.hpp"
+#include <cstring>
+#include <algorithm>
+
+using namespace timl;
+
+PushParser::PushParser(ValueSizePolicy policy)
+    : vsz(policy), builder(root, vsz)
+{
+}
+
+void PushParser::reset()
+{
+    step = Step::Root;
+    stack.clear();
+    builder.reset();
+    pending.clear();
+    pending_used = false;
+    has_count_marker = false;
+    header_step = 0;
+    step_start = 0;
+    bytes_so_far = 0;
+    last_code = ParseError::None;
+}
+
+PushParser::Progress PushParser::feed(const byte* data, std::size_t size)
+{
+    if(step == Step::Failed)
+        return Progress{Error, 0};
+    if(step == Step::Done)
+        reset();
+
+    //the Object may only take as much of the fragment as the policy still allows
+    const std::size_t budget = vsz.max_object_size - bytes_so_far;
+    fragment = in = data;
+    in_end = data + std::min(size, budget);
+    clamped = size > budget;
+
+    for(;;)
+    {
+        const byte* b;
+        std::pair<std::size_t, bool> icount;
+        switch (step) {
+        case Step::Root:
+            if(not (b = take(1)))
+                return stall();
+            if(not isObjectStart(*b))
+            {
+                fail(ParseError::NotAnObject, step_start);
+                return stall();
+            }
+            marker = *b;
+            header_step = 0;
+            go(Step::Header);
+            break;
+
+        case Step::Header:
+            if(not header())
+                return stall();
+            break;
+
+        case Step::Key:
+            if(not (b = take(1)))
+                return stall();
+            wanted = *b;
+            go(Step::KeyBytes);
+            break;
+
+        case Step::KeyBytes:
+            if(not (b = take(wanted)))
+                return stall();
+            builder.key(StringRef(reinterpret_cast<const char*>(b), wanted));
+            go(Step::Value);
+            break;
+
+        case Step::Value:
+            marker = stack.back().type_mark;
+            if(marker == 0)
+            {
+                if(not (b = take(1)))
+                    return stall();
+                marker = *b;
+            }
+            switch (markerInfo(marker).kind) {
+            case MarkerKind::Null:
+                builder.null();
+                next_item();
+                break;
+            case MarkerKind::True:
+            case MarkerKind::False:
+                builder.boolean(isTrue(marker));
+                next_item();
+                break;
+            case MarkerKind::String:
+            case MarkerKind::Binary:
+                go(Step::SequenceSize);
+                break;
+            case MarkerKind::Object:
+            case MarkerKind::HetroArray:
+            case MarkerKind::HomoArray:
+                header_step = 0;
+                go(Step::Header);
+                break;
+            case MarkerKind::Invalid:
+                fail(ParseError::UnknownMarker, step_start);
+                return stall();
+            default:
+                go(Step::Scalar);
+            }
+            break;
+
+        case Step::Scalar:
+            if(not (b = take(markerInfo(marker).width)))
+                return stall();
+            scalar(b);
+            next_item();
+            break;
+
+        case Step::SequenceSize:
+        {
+            if(not take_count(icount))
+                return stall();
+            const bool is_string = isString(marker);
+            if(not icount.second)
+                fail(ParseError::InvalidCount, step_start);
+            else if(icount.first > (is_string ? vsz.max_string_size : vsz.max_binary_size))
+                fail(is_string ? ParseError::StringTooLarge : ParseError::BinaryTooLarge, step_start);
+            if(step == Step::Failed)
+                return stall();
+            wanted = icount.first;
+            go(Step::SequenceBytes);
+            break;
+        }
+
+        case Step::SequenceBytes:
+            if(not (b = take(wanted)))
+                return stall();
+            if(isString(marker))
+                builder.string(StringRef(reinterpret_cast<const char*>(b), wanted));
+            else
+                builder.binary(ByteSpan(b, wanted));
+            next_item();
+            break;
+
+        case Step::End:
+        {
+            if(not (b = take(1)))
+                return stall();
+            const byte end = stack.back().end;
+            if(*b != end)
+            {
+                fail(ParseError::MissingEnd, step_start);
+                return stall();
+            }
+            stack.pop_back();
+            if(isObjectEnd(end))
+                builder.endObject();
+            else
+                builder.endArray();
+            next_item();
+            break;
+        }
+
+        case Step::Done:
+        {
+            const std::size_t consumed = static_cast<std::size_t>(in - fragment);
+            bytes_so_far += consumed;
+            pending.clear();
+            pending_used = false;
+            return Progress{Complete, consumed};
+        }
+
+        case Step::Failed:
+            return stall();
+        }
+    }
+}
+
+/*!
+ * consumes the next \a sz bytes. They are handed out in place when the fragment holds them all,
+ * otherwise they are gathered into pending, across as many fragments as it takes
+ * \return where they are, valid until the next take(); nullptr if the fragment ran out first
+ */
+const byte* PushParser::take(std::size_t sz)
+{
+    static const byte nothing = 0;
+    if(sz == 0)
+        return &nothing;
+    if(pending_used)
+    {
+        pending.clear();
+        pending_used = false;
+    }
+
+    const std::size_t available = static_cast<std::size_t>(in_end - in);
+    if(pending.empty() and sz <= available)
+    {
+        const byte* b = in;
+        in += sz;
+        return b;
+    }
+
+    const std::size_t chunk = std::min(sz - pending.size(), available);
+    pending.append(reinterpret_cast<const char*>(in), chunk);
+    in += chunk;
+    if(pending.size() < sz)
+        return nullptr;
+    pending_used = true;
+    return reinterpret_cast<const byte*>(pending.data());
+}
+
+//! \see StreamReader::extract_itemCount()
+bool PushParser::take_count(std::pair<std::size_t, bool>& icount)
+{
+    if(not has_count_marker)
+    {
+        const byte* b = take(1);
+        if(not b)
+            return false;
+        count_marker = *b;
+        has_count_marker = true;
+    }
+
+    std::size_t width = 0;
+    if(isUint8(count_marker))
+        width = 1;
+    else if(isUint16(count_marker))
+        width = 2;
+    else if(isUint32(count_marker))
+        width = 4;
+
+    const byte* b = take(width);
+    if(not b)
+        return false;
+    has_count_marker = false;
+
+    if(width == 0)
+        icount = std::make_pair(std::size_t(count_marker), false);
+    else
+    {
+        byte be[4];
+        std::memcpy(be, b, width);
+        icount.first = width == 1 ? fromBigEndian8(be) : width == 2 ? fromBigEndian16(be) : fromBigEndian32(be);
+        icount.second = true;
+    }
+    return true;
+}
+
+/*!
+ * reads the header of the container introduced by \a marker, in the steps of
+ * StreamReader::extract_containerHeader(); header_step tells where a previous fragment left off
+ * \return false if the fragment ran out, or the header is ill-formed
+ */
+bool PushParser::header()
+{
+    std::pair<std::size_t, bool> icount;
+    const MarkerKind kind = markerInfo(marker).kind;
+    if(kind == MarkerKind::HomoArray and header_step == 0)
+    {
+        const byte* b = take(1);
+        if(not b)
+            return false;
+        type_mark = *b;
+        header_step = 1;
+    }
+
+    if(kind != MarkerKind::Object)
+        return take_count(icount) and close_header(icount);
+
+    switch (header_step) {
+    case 0:
+        if(not take_count(icount))
+            return false;
+        if(icount.second or not isWidthMarker(static_cast<byte>(icount.first)))
+            return close_header(icount);
+        header_step = 1;
+        //fall through
+    case 1:
+        if(not take_count(icount))
+            return false;
+        if(not icount.second)
+            return fail(ParseError::IllFormedHeader, step_start);
+        wanted = icount.first;
+        width_start = position();
+        header_step = 2;
+        //fall through
+    default:
+    {
+        if(not take_count(icount))
+            return false;
+        //the width has to cover at least the item count and the ObjectEnd marker
+        const std::size_t consumed = position() - width_start;
+        if(icount.second ? wanted <= consumed : wanted != consumed)
+            return fail(ParseError::IllFormedHeader, step_start);
+        return close_header(icount);
+    }
+    }
+}
+
+//! starts the container whose header ends with \a icount, or emits it whole if it is empty
+bool PushParser::close_header(std::pair<std::size_t, bool> icount)
+{
+    Frame f{0, false, 0, icount.first};
+    switch (markerInfo(marker).kind) {
+    case MarkerKind::Object:
+        f.end = static_cast<byte>(Marker::Object_End);
+        f.keyed = true;
+        break;
+    case MarkerKind::HetroArray:
+        f.end = static_cast<byte>(Marker::HetroArray_End);
+        break;
+    default:
+        f.end = static_cast<byte>(Marker::HomoArray_End);
+        f.type_mark = type_mark;
+        //a type_mark of 0 would otherwise pass for items carrying their own markers
+        if(icount.second and icount.first > 0 and markerInfo(type_mark).kind == MarkerKind::Invalid)
+            return fail(ParseError::UnknownMarker, step_start);
+    }
+
+    if(not icount.second)
+    {
+        if(static_cast<byte>(icount.first) != f.end)
+            return fail(ParseError::IllFormedHeader, step_start);
+        if(f.keyed)
+        {
+            builder.startObject(0);
+            builder.endObject();
+        }
+        else
+        {
+            builder.startArray(0);
+            builder.endArray();
+        }
+        next_item();
+        return true;
+    }
+
+    if(stack.size() >= vsz.max_value_depth)
+        return fail(ParseError::TooDeep, step_start);
+    if(f.keyed)
+        builder.startObject(f.remaining);
+    else
+        builder.startArray(f.remaining);
+    stack.push_back(f);
+    next_item();
+    return true;
+}
+
+//! moves on to what follows a complete value: the next item of its container, its end, or the end of the Object
+void PushParser::next_item()
+{
+    if(stack.empty())
+    {
+        go(Step::Done);
+        return;
+    }
+
+    Frame& f = stack.back();
+    if(f.remaining == 0)
+    {
+        go(Step::End);
+        return;
+    }
+    --f.remaining;
+    go(f.keyed ? Step::Key : Step::Value);
+}
+
+//! emits the fixed width value introduced by \a marker; \see StreamReader::extract_integer()
+void PushParser::scalar(const byte* payload)
+{
+    const MarkerInfo& info = markerInfo(marker);
+    byte b[8] = {};
+    std::memcpy(b, payload, info.width);
+    uint64_t v;
+    std::memcpy(&v, b, 8);
+    v = fromBigEndian64(v);
+    const unsigned shift = 64 - 8 * info.width;
+    v = info.is_signed ? static_cast<uint64_t>(static_cast<int64_t>(v) >> shift) : v >> shift;
+
+    switch (info.kind) {
+    case MarkerKind::Char:
+        builder.character(static_cast<char>(v));
+        break;
+    case MarkerKind::SignedInt:
+        builder.int64(static_cast<long long>(v));
+        break;
+    case MarkerKind::UnsignedInt:
+        builder.uint64(v);
+        break;
+    default:
+    {
+        const uint32_t bits32 = static_cast<uint32_t>(v);
+        float f;
+        double d;
+        std::memcpy(&f, &bits32, 4);
+        std::memcpy(&d, &v, 8);
+        builder.float64(info.width == 4 ? f : d);
+    }
+    }
+}
+
+bool PushParser::fail(ParseError code, std::size_t at)
+{
+    step = Step::Failed;
+    last_code = code;
+    error_at = at;
+    return false;
+}
+
+//! ends a feed() that can't go on: the fragment ran out, or the Object is malformed
+PushParser::Progress PushParser::stall()
+{
+    if(step != Step::Failed and clamped)
+        fail(ParseError::ObjectTooLarge, vsz.max_object_size);
+
+    const std::size_t consumed = static_cast<std::size_t>(in - fragment);
+    bytes_so_far += consumed;
+    return Progress{step == Step::Failed ? Error : NeedMore, consumed};
+}
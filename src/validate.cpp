@@ -0,0 +1,319 @@
+/*
+ * Copyright(C):    WhiZTiM, 2015
+ *
+ * This file is part of the TIML::UBEX C++14 library
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ *      (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Author: Ibrahim Timothy Onogu
+ * Email:  ionogu@acm.org
+ */
+
+
+#include "validate.hpp"
+#include "stream_helpers.hpp"
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+using namespace timl;
+
+namespace {
+
+    //! Book keeping for a container whose items are being checked
+    struct Frame
+    {
+        byte end;                   //! the marker that closes the container
+        bool keyed;                 //! whether each item is preceded by a key
+        byte type_mark;             //! the marker shared by all items of a HomoArray, 0 if each has its own
+        std::size_t remaining;      //! items not yet checked
+        std::size_t hinted_end;     //! the offset a Width hint says the Object ends at, 0 without one
+    };
+
+    //! the frames of the open containers; the first few live in place so that shallow documents don't allocate
+    class FrameStack
+    {
+    public:
+        std::size_t size() const noexcept { return count; }
+        Frame& top() noexcept { return count > inline_frames ? spilled.back() : local[count - 1]; }
+
+        void push(const Frame& f)
+        {
+            if(count < inline_frames)
+                local[count] = f;
+            else
+                spilled.push_back(f);
+            ++count;
+        }
+
+        void pop()
+        {
+            if(count > inline_frames)
+                spilled.pop_back();
+            --count;
+        }
+
+    private:
+        static const std::size_t inline_frames = 32;
+        Frame local[inline_frames];
+        std::vector<Frame> spilled;
+        std::size_t count = 0;
+    };
+
+    /*!
+     * Nothing in here throws, short of std::bad_alloc for documents nesting past the inline frames:
+     * every step returns false at the first error, which fail() records along with the byte it is at
+     */
+    class Validator
+    {
+    public:
+        Validator(ByteSpan bytes, const ValueSizePolicy& policy)
+            : begin(bytes.data()), pos(bytes.data()), end(bytes.data() + bytes.size()),
+              limit(bytes.data() + std::min(bytes.size(), policy.max_object_size)), vsz(policy) {}
+
+        ParseResult run();
+
+    private:
+        std::size_t offset(const byte* at) const noexcept { return static_cast<std::size_t>(at - begin); }
+        bool fail(ParseError code, const byte* at) noexcept { error = code; error_at = at; return false; }
+        bool take(std::size_t sz, const byte*& at);
+        bool take(std::size_t sz) { const byte* at; return take(sz, at); }
+        bool take_marker(byte& marker);
+        template<typename T> bool take_uint(std::size_t& v);
+        bool item_count(std::pair<std::size_t, bool>& icount);
+        bool sequence_size(std::size_t max, ParseError violation, std::size_t& sz);
+        bool open(byte marker, const byte* at);
+        bool close(const Frame& f);
+        bool push(const Frame& f, const byte* at);
+        bool check_value(byte marker, const byte* at);
+
+        const byte* const begin;
+        const byte* pos;
+        const byte* const end;
+        const byte* const limit;    //! as far as the ValueSizePolicy lets the Object go
+        const ValueSizePolicy& vsz;
+        FrameStack stack;
+        ParseError error = ParseError::None;
+        const byte* error_at = nullptr;
+    };
+
+    //! consumes \a sz bytes, \a at is where they start
+    inline bool Validator::take(std::size_t sz, const byte*& at)
+    {
+        if(sz > static_cast<std::size_t>(limit - pos))
+            return fail(limit < end ? ParseError::ObjectTooLarge : ParseError::UnexpectedEnd, limit);
+        at = pos;
+        pos += sz;
+        return true;
+    }
+
+    inline bool Validator::take_marker(byte& marker)
+    {
+        const byte* at;
+        if(not take(1, at))
+            return false;
+        marker = *at;
+        return true;
+    }
+
+    template<typename T>
+    inline bool Validator::take_uint(std::size_t& v)
+    {
+        const byte* at;
+        if(not take(sizeof(T), at))
+            return false;
+        T t;
+        std::memcpy(&t, at, sizeof(T));
+        v = fromBigEndian(t);
+        return true;
+    }
+
+    //! \see StreamReader::extract_itemCount()
+    bool Validator::item_count(std::pair<std::size_t, bool>& icount)
+    {
+        byte marker;
+        if(not take_marker(marker))
+            return false;
+        icount.second = true;
+        if(isUint8(marker))
+            return take_uint<uint8_t>(icount.first);
+        if(isUint16(marker))
+            return take_uint<uint16_t>(icount.first);
+        if(isUint32(marker))
+            return take_uint<uint32_t>(icount.first);
+        icount = std::make_pair(std::size_t(marker), false);
+        return true;
+    }
+
+    bool Validator::sequence_size(std::size_t max, ParseError violation, std::size_t& sz)
+    {
+        const byte* at = pos;
+        std::pair<std::size_t, bool> icount;
+        if(not item_count(icount))
+            return false;
+        if(not icount.second)
+            return fail(ParseError::InvalidCount, at);
+        if(icount.first > max)
+            return fail(violation, at);
+        sz = icount.first;
+        return true;
+    }
+
+    bool Validator::push(const Frame& f, const byte* at)
+    {
+        if(stack.size() >= vsz.max_value_depth)
+            return fail(ParseError::TooDeep, at);
+        stack.push(f);
+        return true;
+    }
+
+    //! checks the header of the container introduced by \a marker, which is at \a at; \see StreamReader::extract_containerHeader()
+    bool Validator::open(byte marker, const byte* at)
+    {
+        Frame f{0, false, 0, 0, 0};
+        std::pair<std::size_t, bool> icount;
+        switch (markerInfo(marker).kind) {
+        case MarkerKind::Object:
+        {
+            f.end = static_cast<byte>(Marker::Object_End);
+            f.keyed = true;
+            if(not item_count(icount))
+                return false;
+            if(not icount.second and isWidthMarker(static_cast<byte>(icount.first)))
+            {
+                const byte* hint = pos;
+                std::pair<std::size_t, bool> wsize;
+                if(not item_count(wsize))
+                    return false;
+                if(not wsize.second)
+                    return fail(ParseError::IllFormedHeader, hint);
+                const byte* start = pos;
+                if(not item_count(icount))
+                    return false;
+                const std::size_t consumed = static_cast<std::size_t>(pos - start);
+                if(icount.second ? wsize.first <= consumed : wsize.first != consumed)
+                    return fail(ParseError::IllFormedHeader, hint);
+                f.hinted_end = offset(start) + wsize.first;
+            }
+            if(not icount.second)
+                return isObjectEnd(static_cast<byte>(icount.first)) or fail(ParseError::IllFormedHeader, pos - 1);
+            f.remaining = icount.first;
+            return push(f, at);
+        }
+        case MarkerKind::HetroArray:
+            f.end = static_cast<byte>(Marker::HetroArray_End);
+            if(not item_count(icount))
+                return false;
+            if(not icount.second)
+                return isHetroArrayEnd(static_cast<byte>(icount.first)) or fail(ParseError::IllFormedHeader, pos - 1);
+            f.remaining = icount.first;
+            return push(f, at);
+        case MarkerKind::HomoArray:
+        {
+            f.end = static_cast<byte>(Marker::HomoArray_End);
+            if(not take_marker(f.type_mark) or not item_count(icount))
+                return false;
+            if(not icount.second)
+                return isHomoArrayEnd(static_cast<byte>(icount.first)) or fail(ParseError::IllFormedHeader, pos - 1);
+            f.remaining = icount.first;
+            if(not push(f, at))
+                return false;
+
+            //items of a fixed size are stepped over all at once
+            const MarkerInfo& info = markerInfo(f.type_mark);
+            switch (info.kind) {
+            case MarkerKind::Invalid:
+                if(f.remaining > 0)
+                    return fail(ParseError::UnknownMarker, at + 1);
+                return true;
+            case MarkerKind::String:
+            case MarkerKind::Binary:
+            case MarkerKind::Object:
+            case MarkerKind::HetroArray:
+            case MarkerKind::HomoArray:
+                return true;
+            default:
+                stack.top().remaining = 0;
+                return take(f.remaining * info.width);
+            }
+        }
+        default:
+            return fail(ParseError::UnknownMarker, at);
+        }
+    }
+
+    bool Validator::close(const Frame& f)
+    {
+        const byte* at = pos;
+        byte marker;
+        if(not take_marker(marker))
+            return false;
+        if(marker != f.end)
+            return fail(ParseError::MissingEnd, at);
+        if(f.hinted_end and f.hinted_end != offset(pos))
+            return fail(ParseError::WidthMismatch, at);
+        return true;
+    }
+
+    //! checks the value introduced by \a marker, which is at \a at; containers are only opened
+    inline bool Validator::check_value(byte marker, const byte* at)
+    {
+        const MarkerInfo& info = markerInfo(marker);
+        std::size_t sz;
+        switch (info.kind) {
+        case MarkerKind::String:
+            return sequence_size(vsz.max_string_size, ParseError::StringTooLarge, sz) and take(sz);
+        case MarkerKind::Binary:
+            return sequence_size(vsz.max_binary_size, ParseError::BinaryTooLarge, sz) and take(sz);
+        case MarkerKind::Invalid:
+        case MarkerKind::Object:
+        case MarkerKind::HetroArray:
+        case MarkerKind::HomoArray:
+            return open(marker, at);
+        default:
+            return take(info.width);
+        }
+    }
+
+    ParseResult Validator::run()
+    {
+        byte marker;
+        if(not take_marker(marker))
+            return ParseResult{error, offset(error_at)};
+        if(not isObjectStart(marker))
+            return ParseResult{ParseError::NotAnObject, 0};
+        bool good = open(marker, begin);
+
+        while(good and stack.size() > 0)
+        {
+            Frame& f = stack.top();
+            if(f.remaining == 0)
+            {
+                good = close(f);
+                stack.pop();
+                continue;
+            }
+
+            --f.remaining;
+            std::size_t key_size = 0;
+            if(f.keyed and not (take_uint<uint8_t>(key_size) and take(key_size)))
+                break;
+            const byte* at = pos;
+            marker = f.type_mark;
+            if(marker == 0 and not take_marker(marker))
+                break;
+            good = check_value(marker, at);
+        }
+        if(error != ParseError::None)
+            return ParseResult{error, offset(error_at)};
+        return ParseResult{ParseError::None, offset(pos)};
+    }
+
+}
+
+ParseResult timl::validate(ByteSpan bytes, const ValueSizePolicy& policy)
+{
+    return Validator(bytes, policy).run();
+}
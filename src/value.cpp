@@ -16,6 +16,7 @@
 #include <cmath>
 #include <limits>
 #include <cstring>
+#include <iterator>
 #include <algorithm>
 #include <iostream>
 
@@ -200,9 +201,10 @@ Value& Value::operator [] (const std::string& s)
 {
     if(vtype == Type::Map)
     {
-        if(value.Map.find(s) == value.Map.end())
-            value.Map.emplace( std::make_pair(s, std::make_unique<Value>(Value())));
-        return *(value.Map[s]);
+        auto it = value.Map.find(Key::borrow(s));
+        if(it == value.Map.end())
+            it = value.Map.emplace(s, std::make_unique<Value>()).first;
+        return *(it->second);
     }
     if(vtype == Type::Null)
     {
@@ -210,8 +212,7 @@ Value& Value::operator [] (const std::string& s)
         destruct();
         construct_fromMap(MapType());
         vtype = Type::Map;
-        value.Map.emplace( std::make_pair(s, std::make_unique<Value>(Value())));
-        return *(value.Map[s]);
+        return *(value.Map.emplace(s, std::make_unique<Value>()).first->second);
     }
     throw value_exception("Attempt to index 'Value'; 'Value' is not a Key-Value pair (aka Object) !");
 }
@@ -219,7 +220,7 @@ Value& Value::operator [] (const std::string& s)
 Value const& Value::operator [] (const std::string& s) const
 {
     if(vtype == Type::Map)
-        return *(const_cast<const MapType&>(value.Map).at(s));
+        return *(const_cast<const MapType&>(value.Map).at(Key::borrow(s)));
     throw value_exception("Attempt to index 'Value const&'; 'Value const&' is not a Key-Value pair (aka Object) !");
 }
 
@@ -251,6 +252,75 @@ void Value::push_back(Value&& v)
     }
 }
 
+Value& Value::emplace(Key key, Value&& v)
+{
+    if(vtype == Type::Null)
+    {
+        destruct();
+        construct_fromMap(MapType());
+        vtype = Type::Map;
+    }
+    if(vtype != Type::Map)
+        throw value_exception("Attempt to index 'Value'; 'Value' is not a Key-Value pair (aka Object) !");
+
+    Uptr& slot = value.Map[std::move(key)];
+    if(slot)
+        *slot = std::move(v);
+    else
+        slot = std::make_unique<Value>(std::move(v));
+    return *slot;
+}
+
+Value& Value::emplace_back(Value&& v)
+{
+    push_back(std::move(v));
+    return *(value.Array.back());
+}
+
+void Value::append(Value&& items)
+{
+    if(items.vtype != Type::Array)
+    {
+        if(items.vtype != Type::Null)
+            push_back(std::move(items));
+        return;
+    }
+
+    switch (vtype) {
+    case Type::Null:
+        *this = std::move(items);
+        return;
+    case Type::Array:
+        break;
+    default:
+    {
+        Value tmp(std::move(*this));
+        construct_fromArray(ArrayType());
+        value.Array.emplace_back(std::make_unique<Value>( std::move(tmp) ));
+        vtype = Type::Array;
+        break;
+    }
+
+    }
+    value.Array.insert(value.Array.end(), std::make_move_iterator(items.value.Array.begin()),
+                                          std::make_move_iterator(items.value.Array.end()));
+    items.value.Array.clear();
+}
+
+void Value::reserve(std::size_t n)
+{
+    switch (vtype) {
+    case Type::Array:
+        value.Array.reserve(n);
+        break;
+    case Type::Map:
+        value.Map.reserve(n);
+        break;
+    default:
+        break;
+    }
+}
+
 void Value::push_back(const Value& v)
 {
     switch (vtype) {
@@ -329,7 +399,8 @@ Value::const_iterator Value::find(const Value& v) const
     }
     case Type::Map:
     {
-        auto it = value.Map.find(v);
+        const std::string key = v.asString();
+        auto it = value.Map.find(Key::borrow(key));
         if(it == value.Map.end())
             return end();
         return const_iterator(this, it);
@@ -350,7 +421,7 @@ Value::Keys Value::keys() const
 
     Keys rtn;
     for(const auto& k : value.Map)
-        rtn.push_back( k.first );
+        rtn.push_back( k.first.str() );
     return rtn;
 }
 
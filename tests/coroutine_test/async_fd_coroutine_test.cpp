@@ -0,0 +1,167 @@
+#include "value.hpp"
+#include "async_fd.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifdef UBEX_HAS_COROUTINES
+
+using namespace timl;
+
+namespace {
+
+    //! a connected pair of non-blocking sockets, with small buffers so that writes fall short
+    struct SocketPair
+    {
+        int fds[2];
+
+        SocketPair()
+        {
+            CPPUNIT_ASSERT_EQUAL( 0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) );
+            for(int fd : fds)
+            {
+                const int size = 4096;
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof size);
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof size);
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            }
+        }
+        ~SocketPair() { ::close(fds[0]); ::close(fds[1]); }
+    };
+
+    //! one end of a connection
+    struct Peer
+    {
+        Peer(EventLoop& loop, int fd) : reader(loop, fd, defaultStreamReaderPolicy(), 1024), writer(loop, fd) {}
+
+        AsyncReader reader;
+        AsyncWriter writer;
+        IoStatus ended = IoStatus::WouldBlock;
+        std::size_t echoed = 0;
+        bool finished = false;
+    };
+
+    //! writes back every document it reads, until the peer closes
+    Detached echo(Peer& p)
+    {
+        Value v;
+        IoStatus s;
+        while((s = co_await p.reader.next(v)) == IoStatus::Ready)
+            if((s = co_await p.writer.write(v)) != IoStatus::Ready)
+                break;
+        p.ended = s;
+        p.finished = true;
+    }
+
+    //! sends the documents one at a time, checking that each comes back before the next; closes once done
+    Detached ping(Peer& p, const std::vector<Value>& documents)
+    {
+        Value v;
+        for(const Value& doc : documents)
+        {
+            if((p.ended = co_await p.writer.write(doc)) != IoStatus::Ready)
+                break;
+            if((p.ended = co_await p.reader.next(v)) != IoStatus::Ready or not (v == doc))
+                break;
+            ++p.echoed;
+        }
+        ::shutdown(p.writer.fd(), SHUT_WR);
+        p.finished = true;
+    }
+
+}
+
+class Async_Fd_Coroutine_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Async_Fd_Coroutine_Test );
+    CPPUNIT_TEST( test_echo );
+    CPPUNIT_TEST( test_readyAwaiters );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        documents.clear();
+        for(int i = 0; i < 4; ++i)
+        {
+            Value v = sample_document();
+            v["seq"] = i;
+            v["blob"] = std::string(i * 3000, 'x');     //outgrows the socket buffers, so that both awaiters suspend
+            documents.push_back(std::move(v));
+        }
+    }
+private:
+    std::vector<Value> documents;
+
+public:
+
+    void test_echo()
+    {
+        //1000 coroutines: a client and a server on each of 500 connections, two fds apiece
+        rlimit limit;
+        if(::getrlimit(RLIMIT_NOFILE, &limit) == 0 and limit.rlim_cur < 2048 and limit.rlim_max >= 2048)
+        {
+            limit.rlim_cur = 2048;
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+
+        EventLoop loop;
+        std::vector<std::unique_ptr<SocketPair>> pairs;
+        std::vector<std::unique_ptr<Peer>> servers, clients;
+        for(int i = 0; i < 500; ++i)
+        {
+            pairs.emplace_back(new SocketPair);
+            servers.emplace_back(new Peer(loop, pairs.back()->fds[1]));
+            clients.emplace_back(new Peer(loop, pairs.back()->fds[0]));
+            echo(*servers.back());
+            ping(*clients.back(), documents);
+        }
+        loop.run();
+
+        for(std::size_t i = 0; i < clients.size(); ++i)
+        {
+            CPPUNIT_ASSERT( clients[i]->finished and servers[i]->finished );
+            CPPUNIT_ASSERT_EQUAL( documents.size(), clients[i]->echoed );
+            CPPUNIT_ASSERT( servers[i]->ended == IoStatus::Closed );
+            CPPUNIT_ASSERT_EQUAL( std::size_t(0), servers[i]->writer.queued() );
+        }
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), loop.pending() );
+    }
+
+    void test_readyAwaiters()
+    {
+        EventLoop loop;
+        SocketPair pair;
+        Peer client(loop, pair.fds[0]);
+        Peer server(loop, pair.fds[1]);
+        const std::vector<Value> small(1, documents[0]);
+
+        //a write the fd takes whole is awaited without suspending; the echo is not there yet
+        ping(client, small);
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), client.writer.queued() );
+        CPPUNIT_ASSERT( not client.finished );
+        echo(server);
+        CPPUNIT_ASSERT( not server.finished );      //waits for the next document, or the close
+        loop.run();
+
+        CPPUNIT_ASSERT( client.finished and server.finished );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), client.echoed );
+        CPPUNIT_ASSERT( server.ended == IoStatus::Closed );
+
+        //bytes already there are awaited without suspending, here a malformed document ending the server at once
+        SocketPair bogus;
+        Peer broken(loop, bogus.fds[1]);
+        CPPUNIT_ASSERT_EQUAL( ssize_t(3), ::write(bogus.fds[0], "\x01\x02\x03", 3) );
+        echo(broken);
+        CPPUNIT_ASSERT( broken.finished );
+        CPPUNIT_ASSERT( broken.ended == IoStatus::Error );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Async_Fd_Coroutine_Test );
+
+#endif // UBEX_HAS_COROUTINES
@@ -0,0 +1,211 @@
+#include "value.hpp"
+#include "async_fd.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_async_fd_test = 0;
+
+namespace {
+
+    //! a connected pair of non-blocking sockets, with small buffers so that writes fall short
+    struct SocketPair
+    {
+        int fds[2];
+
+        SocketPair()
+        {
+            ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+            for(int fd : fds)
+            {
+                const int size = 4096;
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof size);
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof size);
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            }
+        }
+        ~SocketPair() { ::close(fds[0]); ::close(fds[1]); }
+    };
+
+    void put(int fd, const char* bytes, std::size_t size)
+    {
+        CPPUNIT_ASSERT_EQUAL( ssize_t(size), ::write(fd, bytes, size) );
+    }
+
+    //! writes back every document it reads, until the peer closes
+    struct Echo
+    {
+        Echo(EventLoop& loop, int fd) : reader(loop, fd, defaultStreamReaderPolicy(), 1024), writer(loop, fd) {}
+
+        void serve()
+        {
+            reader.next(v, [this](IoStatus s) {
+                if(s != IoStatus::Ready)
+                    return void(ended = s);
+                writer.write(v, [this](IoStatus w) {
+                    if(w == IoStatus::Ready)
+                        serve();
+                    else
+                        ended = w;
+                });
+            });
+        }
+
+        AsyncReader reader;
+        AsyncWriter writer;
+        Value v;
+        IoStatus ended = IoStatus::WouldBlock;
+    };
+
+    //! sends documents, while checking that the echoes come back in order
+    struct Client
+    {
+        Client(EventLoop& loop, int fd, const std::vector<Value>& docs)
+            : reader(loop, fd), writer(loop, fd), documents(docs) {}
+
+        void send(std::size_t i)
+        {
+            if(i == documents.size())
+                return;
+            writer.write(documents[i], [this, i](IoStatus s) {
+                if(s == IoStatus::Ready)
+                    send(i + 1);
+            });
+        }
+
+        void receive()
+        {
+            reader.next(v, [this](IoStatus s) {
+                if(s != IoStatus::Ready or not (v == documents[echoed]))
+                    return;
+                if(++echoed == documents.size())
+                    ::shutdown(reader.fd(), SHUT_WR);
+                else
+                    receive();
+            });
+        }
+
+        AsyncReader reader;
+        AsyncWriter writer;
+        const std::vector<Value>& documents;
+        Value v;
+        std::size_t echoed = 0;
+    };
+
+}
+
+class Async_Fd_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Async_Fd_Test );
+    CPPUNIT_TEST( test_echo );
+    CPPUNIT_TEST( test_partialDocuments );
+    CPPUNIT_TEST( test_errors );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        documents.clear();
+        for(int i = 0; i < 30; ++i)
+        {
+            Value v = sample_document();
+            v["seq"] = i;
+            v["blob"] = std::string(i * 300, 'x');
+            documents.push_back(std::move(v));
+        }
+    }
+private:
+    std::vector<Value> documents;
+
+public:
+
+    void test_echo()
+    {
+        EventLoop loop;
+        std::vector<std::unique_ptr<SocketPair>> pairs;
+        std::vector<std::unique_ptr<Echo>> servers;
+        std::vector<std::unique_ptr<Client>> clients;
+        for(int i = 0; i < 50; ++i)
+        {
+            pairs.emplace_back(new SocketPair);
+            servers.emplace_back(new Echo(loop, pairs.back()->fds[1]));
+            clients.emplace_back(new Client(loop, pairs.back()->fds[0], documents));
+            servers.back()->serve();
+            clients.back()->send(0);
+            clients.back()->receive();
+        }
+        loop.run();
+
+        for(std::size_t i = 0; i < clients.size(); ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL( documents.size(), clients[i]->echoed );
+            CPPUNIT_ASSERT( servers[i]->ended == IoStatus::Closed );
+            CPPUNIT_ASSERT_EQUAL( std::size_t(0), clients[i]->writer.queued() );
+        }
+    }
+
+    void test_partialDocuments()
+    {
+        EventLoop loop;
+        SocketPair pair;
+        AsyncReader reader(loop, pair.fds[1], defaultStreamReaderPolicy(), 16);
+        const std::string doc = encode(documents[2]);
+
+        Value v;
+        CPPUNIT_ASSERT( reader.tryNext(v) == IoStatus::WouldBlock );
+        for(std::size_t i = 0; i + 1 < doc.size(); i += 100)
+        {
+            const std::size_t sz = std::min<std::size_t>(100, doc.size() - 1 - i);
+            put(pair.fds[0], doc.data() + i, sz);
+            CPPUNIT_ASSERT( reader.tryNext(v) == IoStatus::WouldBlock );
+        }
+        put(pair.fds[0], doc.data() + doc.size() - 1, 1);
+        CPPUNIT_ASSERT( reader.tryNext(v) == IoStatus::Ready );
+        CPPUNIT_ASSERT( v == documents[2] );
+
+        //a read waiting on the loop completes once the rest arrives
+        IoStatus status = IoStatus::WouldBlock;
+        reader.next(v, [&](IoStatus s) { status = s; });
+        put(pair.fds[0], doc.data(), doc.size() / 2);
+        loop.runOnce(0);
+        CPPUNIT_ASSERT( status == IoStatus::WouldBlock );
+        put(pair.fds[0], doc.data() + doc.size() / 2, doc.size() - doc.size() / 2);
+        loop.run();
+        CPPUNIT_ASSERT( status == IoStatus::Ready );
+        CPPUNIT_ASSERT( v == documents[2] );
+
+        ::shutdown(pair.fds[0], SHUT_WR);
+        CPPUNIT_ASSERT( reader.tryNext(v) == IoStatus::Closed );
+    }
+
+    void test_errors()
+    {
+        EventLoop loop;
+        const std::string doc = encode(documents[0]);
+        Value v;
+
+        //the peer hangs up half way through a document
+        SocketPair cut;
+        AsyncReader truncated(loop, cut.fds[1]);
+        put(cut.fds[0], doc.data(), doc.size() / 2);
+        ::shutdown(cut.fds[0], SHUT_WR);
+        CPPUNIT_ASSERT( truncated.tryNext(v) == IoStatus::Error );
+        CPPUNIT_ASSERT_EQUAL( std::string("Unexpected end of Stream"), truncated.getLastError() );
+
+        SocketPair bogus;
+        AsyncReader malformed(loop, bogus.fds[1]);
+        put(bogus.fds[0], "[I\x00]", 4);
+        CPPUNIT_ASSERT( malformed.tryNext(v) == IoStatus::Error );
+        CPPUNIT_ASSERT( malformed.getParseResult().code == ParseError::NotAnObject );
+
+        AsyncWriter writer(loop, bogus.fds[0]);
+        CPPUNIT_ASSERT( writer.tryWrite(Value(42)) == IoStatus::Error );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), writer.queued() );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Async_Fd_Test );
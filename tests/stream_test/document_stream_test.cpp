@@ -0,0 +1,119 @@
+#include "value.hpp"
+#include "document_stream.hpp"
+#include "key_table.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <sstream>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_document_stream_test = 0;
+
+class Document_Stream_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Document_Stream_Test );
+    CPPUNIT_TEST( test_iteration );
+    CPPUNIT_TEST( test_emptySource );
+    CPPUNIT_TEST( test_malformedDocument );
+    CPPUNIT_TEST( test_readerSettings );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        records.clear();
+        log.clear();
+        for(int i = 0; i < 50; ++i)
+        {
+            Value record = sample_document();
+            record["seq"] = i;
+            log += encode(record);
+            records.push_back(std::move(record));
+        }
+    }
+private:
+    std::vector<Value> records;
+    std::string log;
+public:
+
+    void test_iteration()
+    {
+        for(std::size_t buffer_size : {0, 7, 4096})
+        {
+            std::istringstream ss(log);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            DocumentStream<std::istringstream> documents(reader);
+            std::size_t n = 0;
+            for(Value& v : documents)
+                CPPUNIT_ASSERT( v == records[n++] );
+
+            CPPUNIT_ASSERT_EQUAL( records.size(), n );
+            CPPUNIT_ASSERT( not documents.failed() );
+            CPPUNIT_ASSERT_EQUAL( records.size(), documents.stats().documents );
+            CPPUNIT_ASSERT_EQUAL( log.size(), documents.stats().bytes );
+            CPPUNIT_ASSERT( not documents.next() );
+        }
+
+        //a temporary range, over memory
+        ByteSpan span(reinterpret_cast<const byte*>(log.data()), log.size());
+        BufferReader reader(span);
+        std::size_t n = 0;
+        for(const Value& v : DocumentStream<ByteSpan>(reader))
+            CPPUNIT_ASSERT_EQUAL( n++, static_cast<std::size_t>(v["seq"].asInt64()) );
+        CPPUNIT_ASSERT_EQUAL( records.size(), n );
+
+        //over an unchecked reader
+        std::istringstream ss(log);
+        StreamReader<std::istringstream, UncheckedSizePolicy> unchecked(ss);
+        n = 0;
+        for(const Value& v : DocumentStream<std::istringstream, UncheckedSizePolicy>(unchecked))
+            CPPUNIT_ASSERT( v == records[n++] );
+        CPPUNIT_ASSERT_EQUAL( records.size(), n );
+    }
+
+    void test_emptySource()
+    {
+        std::istringstream ss;
+        StreamReader<std::istringstream> reader(ss);
+        DocumentStream<std::istringstream> documents(reader);
+        CPPUNIT_ASSERT( documents.begin() == documents.end() );
+        CPPUNIT_ASSERT( not documents.failed() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), documents.stats().bytes );
+    }
+
+    void test_malformedDocument()
+    {
+        std::istringstream ss(log.substr(0, log.size() - 1));
+        StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), 64);
+        DocumentStream<std::istringstream> documents(reader);
+        std::size_t n = 0;
+        for(auto it = documents.begin(); it != documents.end(); ++it)
+            ++n;
+        CPPUNIT_ASSERT_EQUAL( records.size() - 1, n );
+        CPPUNIT_ASSERT( documents.failed() );
+        CPPUNIT_ASSERT( not documents.getLastError().empty() );
+        CPPUNIT_ASSERT_EQUAL( records.size() - 1, documents.stats().documents );
+    }
+
+    void test_readerSettings()
+    {
+        //documents are decoded into the containers the previous one left, and their keys interned
+        std::istringstream ss(log);
+        StreamReader<std::istringstream> reader(ss);
+        KeyTable keys;
+        reader.setKeyTable(&keys);
+        reader.setRecycling(true);
+        DocumentStream<std::istringstream> documents(reader);
+        const Value* first_fave = nullptr;
+        std::size_t n = 0;
+        for(Value& v : documents)
+        {
+            CPPUNIT_ASSERT( v == records[n++] );
+            if(not first_fave)
+                first_fave = &v["faves"][0];
+            CPPUNIT_ASSERT_EQUAL( first_fave, &v["faves"][0] );
+        }
+        CPPUNIT_ASSERT_EQUAL( records.size(), n );
+        CPPUNIT_ASSERT( keys.size() >= records[0].keys().size() );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Document_Stream_Test );
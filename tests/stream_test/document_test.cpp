@@ -0,0 +1,208 @@
+#include "value.hpp"
+#include "document.hpp"
+#include "stream_reader.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_document_test = 0;
+
+class Document_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Document_Test );
+    CPPUNIT_TEST( test_decoding );
+    CPPUNIT_TEST( test_lookup );
+    CPPUNIT_TEST( test_duplicateKeys );
+    CPPUNIT_TEST( test_malformedDocument );
+    CPPUNIT_TEST( test_reuse );
+    CPPUNIT_TEST( test_move );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        document = Value();
+        for(int i = 0; i < 50; ++i)
+        {
+            Value record = sample_document();
+            record["seq"] = i;
+            document["records"].push_back(std::move(record));
+        }
+        document["empty"] = "";
+        encoded = encode(document);
+    }
+private:
+    Value document;
+    std::string encoded;
+
+    static bool decode(const std::string& bytes, Document& doc)
+    {
+        ByteSpan span(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+        BufferReader reader(span);
+        return reader.getNextValue(doc);
+    }
+
+public:
+
+    void test_decoding()
+    {
+        Document doc(256);      //small enough to need many blocks
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        CPPUNIT_ASSERT( doc.root().toValue() == document );
+
+        Value small;
+        small["items"].push_back("lonely");
+        small["items"].push_back(3);
+        Document little;
+        CPPUNIT_ASSERT( decode(encode(small), little) );
+        CPPUNIT_ASSERT( little.root()["items"].isArray() );
+        CPPUNIT_ASSERT_EQUAL( std::string("lonely"), little.root()["items"][0].asString() );
+        CPPUNIT_ASSERT_EQUAL( 3, little.root()["items"][1].asInt() );
+
+        Document empty;
+        CPPUNIT_ASSERT( decode(std::string("{I\x00}", 4), empty) );
+        CPPUNIT_ASSERT( empty.root().isNull() );
+        CPPUNIT_ASSERT( empty.root().begin() == empty.root().end() );
+    }
+
+    void test_lookup()
+    {
+        Document doc;
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        const ValueView& root = doc.root();
+        const Value& expected = document["records"][7];
+
+        CPPUNIT_ASSERT( root.isMap() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(50), root["records"].size() );
+        const ValueView& record = root["records"][7];
+        CPPUNIT_ASSERT_EQUAL( expected["name"].asString(), record["name"].asString() );
+        CPPUNIT_ASSERT( record["seq"].toValue() == expected["seq"] );
+        CPPUNIT_ASSERT( record["faves"][5].isFloat() );
+        CPPUNIT_ASSERT_EQUAL( -9.80665, record["faves"][5].asFloat() );
+        CPPUNIT_ASSERT_EQUAL( std::string("Onogu"), record["surname"].str().str() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(4), record["binary"].bytes().size() );
+        CPPUNIT_ASSERT( record["binary"].asBinary() == expected["binary"].asBinary() );
+        CPPUNIT_ASSERT( root["empty"].isString() and root["empty"].str().empty() );
+
+        Value::Keys keys = record.keys();
+        Value::Keys expected_keys = expected.keys();
+        std::sort(keys.begin(), keys.end());
+        std::sort(expected_keys.begin(), expected_keys.end());
+        CPPUNIT_ASSERT( keys == expected_keys );
+        for(const ValueView& item : record)
+            CPPUNIT_ASSERT( item.toValue() == expected[item.key().str()] );
+
+        CPPUNIT_ASSERT( record.contains("seq") and not record.contains("nope") );
+        CPPUNIT_ASSERT_THROW( record["nope"], std::out_of_range );
+        CPPUNIT_ASSERT_THROW( root["records"][50], std::out_of_range );
+        CPPUNIT_ASSERT_THROW( record[0], value_exception );
+        CPPUNIT_ASSERT_THROW( root["records"]["seq"], value_exception );
+        CPPUNIT_ASSERT( record["name"].keys().empty() );
+    }
+
+    void test_duplicateKeys()
+    {
+        const std::string both("{I\x02\x01" "aI\x01\x01" "aI\x02}");
+        Value second;
+        second["a"] = 2;
+
+        Document doc;
+        CPPUNIT_ASSERT( decode(both, doc) );
+        CPPUNIT_ASSERT_EQUAL( 2, doc.root()["a"].asInt() );
+        CPPUNIT_ASSERT( doc.root().toValue() == second );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), doc.root().size() );
+
+        //only the last of each repeated key is kept, where it stands, in nested Maps too
+        const std::string repeated("{I\x05" "\x01" "bI\x01" "\x01" "a{I\x03\x01" "xI\x01\x01" "yI\x02\x01" "xI\x03}"
+                                   "\x01" "cI\x03" "\x01" "bI\x04" "\x01" "dI\x05}", 38);
+        CPPUNIT_ASSERT( decode(repeated, doc) );
+        const ValueView& root = doc.root();
+        const Value expected = root.toValue();
+        CPPUNIT_ASSERT_EQUAL( expected.size(), root.size() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(4), root.size() );
+        CPPUNIT_ASSERT( root.keys() == Value::Keys({"a", "c", "b", "d"}) );
+        CPPUNIT_ASSERT_EQUAL( 4, root["b"].asInt() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(2), root["a"].size() );
+        CPPUNIT_ASSERT( root["a"].keys() == Value::Keys({"y", "x"}) );
+        CPPUNIT_ASSERT_EQUAL( 3, root["a"]["x"].asInt() );
+        std::size_t items = 0;
+        for(const ValueView& item : root)
+        {
+            CPPUNIT_ASSERT( item.toValue() == expected[item.key().str()] );
+            ++items;
+        }
+        CPPUNIT_ASSERT_EQUAL( expected.size(), items );
+
+        //past a handful of items, they are sorted by key to find the repeats
+        std::string many("{I\x1e");
+        for(int i = 0; i < 30; ++i)
+            many += std::string("\x04" "key") + char('0' + i % 10) + 'i' + char(i);
+        many += '}';
+        CPPUNIT_ASSERT( decode(many, doc) );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(10), doc.root().size() );
+        CPPUNIT_ASSERT_EQUAL( doc.root().toValue().size(), doc.root().size() );
+        CPPUNIT_ASSERT_EQUAL( 27, doc.root()["key7"].asInt() );
+        CPPUNIT_ASSERT_EQUAL( std::string("key0"), doc.root().keys().front() );
+    }
+
+    void test_malformedDocument()
+    {
+        Document doc;
+        CPPUNIT_ASSERT( not decode(encoded.substr(0, encoded.size() / 2), doc) );
+
+        //a failed decode leaves nothing behind for the next one
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        CPPUNIT_ASSERT( doc.root().toValue() == document );
+    }
+
+    void test_reuse()
+    {
+        Document doc(1024);
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        const std::size_t used = doc.bytesUsed();
+        CPPUNIT_ASSERT( used > 1024 );
+
+        //the blocks of the first document are merged into one that holds the next document whole
+        for(int round = 0; round < 3; ++round)
+        {
+            CPPUNIT_ASSERT( decode(encoded, doc) );
+            CPPUNIT_ASSERT( doc.root().toValue() == document );
+            CPPUNIT_ASSERT_EQUAL( used, doc.bytesUsed() );
+        }
+        const std::size_t reserved = doc.bytesReserved();
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        CPPUNIT_ASSERT_EQUAL( reserved, doc.bytesReserved() );
+
+        doc.clear();
+        CPPUNIT_ASSERT( doc.root().isNull() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), doc.bytesUsed() );
+    }
+
+    void test_move()
+    {
+        Document doc;
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        const ValueView* records = &doc.root()["records"];
+
+        Document moved(std::move(doc));
+        CPPUNIT_ASSERT( &moved.root()["records"] == records );
+        CPPUNIT_ASSERT( moved.root().toValue() == document );
+
+        Document assigned;
+        assigned = std::move(moved);
+        CPPUNIT_ASSERT( assigned.root().toValue() == document );
+
+        //the moved from Documents are empty, and may be refilled
+        CPPUNIT_ASSERT( doc.root().isNull() and moved.root().isNull() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), doc.bytesReserved() );
+        CPPUNIT_ASSERT( decode(encoded, doc) );
+        CPPUNIT_ASSERT( doc.root().toValue() == document );
+        CPPUNIT_ASSERT( decode(encoded, moved) );
+        CPPUNIT_ASSERT( moved.root().toValue() == document );
+        CPPUNIT_ASSERT( assigned.root().toValue() == document );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Document_Test );
@@ -0,0 +1,83 @@
+#include "endian_kernels.hpp"
+#include "stream_helpers.hpp"
+#include <vector>
+#include <algorithm>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_endian_kernels_test = 0;
+
+class Endian_Kernels_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Endian_Kernels_Test );
+    CPPUNIT_TEST( test_dispatch );
+    CPPUNIT_TEST( test_kernelsAgree );
+    CPPUNIT_TEST( test_batchConversions );
+    CPPUNIT_TEST_SUITE_END();
+public:
+
+    void test_dispatch()
+    {
+        CPPUNIT_ASSERT( endianKernels(EndianIsa::Scalar) != nullptr );
+        const EndianKernels& best = endianKernels();
+        CPPUNIT_ASSERT( endianKernels(best.isa) == &best );
+    }
+
+    //! every kernel the CPU runs, on every tail length and misalignment, byte for byte
+    void test_kernelsAgree()
+    {
+        std::vector<byte> src(8 * 100 + 3);
+        for(std::size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<byte>(i * 7 + 1);
+
+        for(EndianIsa isa : {EndianIsa::SSE2, EndianIsa::SSSE3, EndianIsa::AVX2, EndianIsa::AVX512})
+        {
+            const EndianKernels* k = endianKernels(isa);
+            if(not k)
+                continue;
+            for(std::size_t size : {2, 4, 8})
+            {
+                auto swap = size == 2 ? k->swap16 : (size == 4 ? k->swap32 : k->swap64);
+                for(std::size_t n = 0; n <= 100; ++n)
+                    for(std::size_t offset = 0; offset < 3; ++offset)
+                    {
+                        std::vector<byte> out(n * size + 1, 0xee);
+                        swap(src.data() + offset, n, out.data());
+                        for(std::size_t i = 0; i < n * size; ++i)
+                            CPPUNIT_ASSERT_EQUAL( src[offset + i / size * size + size - 1 - i % size], out[i] );
+                        CPPUNIT_ASSERT_EQUAL( byte(0xee), out.back() );
+
+                        std::vector<byte> in_place(src.begin() + offset, src.begin() + offset + n * size);
+                        swap(in_place.data(), n, in_place.data());
+                        CPPUNIT_ASSERT( std::equal(in_place.begin(), in_place.end(), out.begin()) );
+                    }
+            }
+        }
+    }
+
+    void test_batchConversions()
+    {
+        std::vector<double> doubles;
+        std::vector<uint16_t> shorts;
+        for(int i = 0; i < 50; ++i)
+        {
+            doubles.push_back(i * -0.125);
+            shorts.push_back(static_cast<uint16_t>(i * 1000));
+        }
+
+        std::vector<byte> encoded(doubles.size() * 8);
+        toBigEndianFloat64(doubles.data(), doubles.size(), encoded.data());
+        CPPUNIT_ASSERT_EQUAL( doubles[7], fromBigEndianFloat64(encoded.data() + 7 * 8) );
+        std::vector<double> decoded(doubles.size());
+        fromBigEndianFloat64(encoded.data(), decoded.size(), decoded.data());
+        CPPUNIT_ASSERT( decoded == doubles );
+
+        toBigEndian16(shorts.data(), shorts.size(), encoded.data());
+        CPPUNIT_ASSERT_EQUAL( shorts[33], fromBigEndian16(encoded.data() + 33 * 2) );
+        std::vector<uint16_t> back(shorts.size());
+        fromBigEndian16(encoded.data(), back.size(), back.data());
+        CPPUNIT_ASSERT( back == shorts );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Endian_Kernels_Test );
@@ -0,0 +1,151 @@
+#include "value.hpp"
+#include "stream_reader.hpp"
+#include "../test_utils/format_helpers.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <sstream>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_event_parser_test = 0;
+
+namespace {
+
+    //! records every event as a compact string
+    struct TraceHandler
+    {
+        std::ostringstream trace;
+        void null()                         { trace << "n "; }
+        void boolean(bool b)                { trace << (b ? "t " : "f "); }
+        void character(char c)              { trace << "c:" << c << ' '; }
+        void int64(long long ll)            { trace << "i:" << ll << ' '; }
+        void uint64(unsigned long long ull) { trace << "u:" << ull << ' '; }
+        void float64(double d)              { trace << "d:" << d << ' '; }
+        void string(StringRef s)            { trace << "s:" << s.str() << ' '; }
+        void binary(ByteSpan b)             { trace << "b:" << b.size() << ' '; }
+        void startObject(std::size_t count) { trace << "{" << count << ' '; }
+        void key(StringRef k)               { trace << k.str() << "= "; }
+        void endObject()                    { trace << "} "; }
+        void startArray(std::size_t count)  { trace << "[" << count << ' '; }
+        void endArray()                     { trace << "] "; }
+    };
+
+    //! checks that every view handed out points into [first, last)
+    struct ViewChecker : BasicHandler
+    {
+        const byte* first;
+        const byte* last;
+        std::size_t views = 0;
+        bool all_inside = true;
+
+        void check(const void* p, std::size_t sz)
+        {
+            auto b = static_cast<const byte*>(p);
+            all_inside = all_inside and b >= first and b + sz <= last;
+            ++views;
+        }
+        void key(StringRef k)    { check(k.data(), k.size()); }
+        void string(StringRef s) { check(s.data(), s.size()); }
+        void binary(ByteSpan b)  { check(b.data(), b.size()); }
+    };
+
+    struct AbortOnBinary : BasicHandler
+    {
+        void binary(ByteSpan) { throw parsing_exception("binary not welcome here"); }
+    };
+
+}
+
+class Event_Parser_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Event_Parser_Test );
+    CPPUNIT_TEST( test_eventOrder );
+    CPPUNIT_TEST( test_viewsPointIntoBuffer );
+    CPPUNIT_TEST( test_streamAndBufferAgree );
+    CPPUNIT_TEST( test_handlerAbort );
+    CPPUNIT_TEST( test_unknownMarker );
+    CPPUNIT_TEST( test_hostileCount );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        document = sample_document();
+        encoded = encode(document);
+    }
+private:
+    Value document;
+    std::string encoded;
+
+    ByteSpan span() const
+    { return ByteSpan(reinterpret_cast<const byte*>(encoded.data()), encoded.size()); }
+public:
+
+    void test_eventOrder()
+    {
+        Value v;
+        v["list"] = {1, -2, 'x', "yo"};
+        const std::string bytes = encode(v);
+        ByteSpan s(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+        BufferReader reader(s);
+        TraceHandler handler;
+        CPPUNIT_ASSERT( reader.parse(handler) );
+        CPPUNIT_ASSERT_EQUAL( std::string("{1 list= [4 u:1 i:-2 c:x s:yo ] } "), handler.trace.str() );
+    }
+
+    void test_viewsPointIntoBuffer()
+    {
+        ByteSpan s = span();
+        BufferReader reader(s);
+        ViewChecker handler;
+        handler.first = s.begin();
+        handler.last = s.end();
+        CPPUNIT_ASSERT( reader.parse(handler) );
+        CPPUNIT_ASSERT( handler.views > 0 );
+        CPPUNIT_ASSERT( handler.all_inside );
+    }
+
+    void test_streamAndBufferAgree()
+    {
+        ByteSpan s = span();
+        BufferReader buffer_reader(s);
+        TraceHandler from_buffer;
+        CPPUNIT_ASSERT( buffer_reader.parse(from_buffer) );
+
+        std::istringstream ss(encoded);
+        StreamReader<std::istringstream> stream_reader(ss, defaultStreamReaderPolicy(), 3);
+        TraceHandler from_stream;
+        CPPUNIT_ASSERT( stream_reader.parse(from_stream) );
+
+        CPPUNIT_ASSERT_EQUAL( from_buffer.trace.str(), from_stream.trace.str() );
+    }
+
+    void test_handlerAbort()
+    {
+        ByteSpan s = span();
+        BufferReader reader(s);
+        AbortOnBinary handler;
+        CPPUNIT_ASSERT( not reader.parse(handler) );
+        CPPUNIT_ASSERT_EQUAL( std::string("binary not welcome here"), reader.getLastError() );
+    }
+
+    void test_unknownMarker()
+    {
+        const byte bytes[] = { '{', 'I', 1, 1, 'k', 'X', '}' };
+        ByteSpan s(bytes, sizeof(bytes));
+        BufferReader reader(s);
+        Value v;
+        CPPUNIT_ASSERT( not reader.getNextValue(v) );
+    }
+
+    void test_hostileCount()
+    {
+        //claims 4 billion items; the builder's reservation is capped by the policy, so decoding fails cleanly
+        const byte bytes[] = { '{', 'I', 1, 1, 'k', '[', 'K', 0xff, 0xff, 0xff, 0xff, 'I', 1, ']', '}' };
+        ByteSpan s(bytes, sizeof(bytes));
+        BufferReader reader(s);
+        Value v;
+        CPPUNIT_ASSERT( not reader.getNextValue(v) );
+    }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Event_Parser_Test );
@@ -0,0 +1,132 @@
+#include "value.hpp"
+#include "key_table.hpp"
+#include "stream_reader.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_key_table_test = 0;
+
+class Key_Table_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Key_Table_Test );
+    CPPUNIT_TEST( test_interning );
+    CPPUNIT_TEST( test_decoding );
+    CPPUNIT_TEST( test_outlivesTable );
+    CPPUNIT_TEST( test_sharedTable );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        records = Value();
+        for(int i = 0; i < 50; ++i)
+        {
+            Value record = sample_document();
+            record["a_rather_long_key_for_a_sequence_number"] = i;
+            records.push_back(std::move(record));
+        }
+        document = Value();
+        document["records"] = records;
+        encoded = encode(document);
+    }
+private:
+    Value records;
+    Value document;
+    std::string encoded;
+
+    Value decode(KeyTable* keys)
+    {
+        ByteSpan bytes(reinterpret_cast<const byte*>(encoded.data()), encoded.size());
+        BufferReader reader(bytes);
+        reader.setKeyTable(keys);
+        Value v;
+        reader.getNextValue(v);
+        return v;
+    }
+
+public:
+
+    void test_interning()
+    {
+        KeyTable table;
+        const Key a = table.intern("a_rather_long_key_for_a_sequence_number");
+        const Key b = table.intern(StringRef(std::string("a_rather_long_key_for_a_sequence_number")));
+        CPPUNIT_ASSERT( a.isInterned() and b.isInterned() );
+        CPPUNIT_ASSERT_EQUAL( &a.str(), &b.str() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), table.size() );
+
+        const Key owned(std::string("a_rather_long_key_for_a_sequence_number"));
+        CPPUNIT_ASSERT( not owned.isInterned() );
+        CPPUNIT_ASSERT( owned == a );
+        CPPUNIT_ASSERT_EQUAL( owned.hash(), a.hash() );
+        CPPUNIT_ASSERT( table.intern("other") != a );
+
+        //past max_keys, keys are still handed out, just not shared
+        KeyTable small(false, 1);
+        CPPUNIT_ASSERT( small.intern("first").isInterned() );
+        const Key second = small.intern("second");
+        CPPUNIT_ASSERT( not second.isInterned() );
+        CPPUNIT_ASSERT_EQUAL( std::string("second"), second.str() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), small.size() );
+    }
+
+    void test_decoding()
+    {
+        KeyTable table;
+        Value v = decode(&table);
+        CPPUNIT_ASSERT( v == document );
+        CPPUNIT_ASSERT( v == decode(nullptr) );
+        const std::size_t distinct = table.size();
+        CPPUNIT_ASSERT( distinct > records[0].keys().size() );
+        CPPUNIT_ASSERT( decode(&table) == document );
+        CPPUNIT_ASSERT_EQUAL( distinct, table.size() );
+
+        //the interned Maps remain ordinary Values
+        Value& first = v["records"][0];
+        CPPUNIT_ASSERT( first["a_rather_long_key_for_a_sequence_number"] == records[0]["a_rather_long_key_for_a_sequence_number"] );
+        first["a_rather_long_key_for_a_sequence_number"] = 7;
+        first["a_new_key"] = true;
+        first.remove(Value("a_new_key"));
+        Value copy = v;
+        CPPUNIT_ASSERT( copy == v );
+        CPPUNIT_ASSERT( not (v == document) );
+
+        KeyTable tiny(false, 2);
+        CPPUNIT_ASSERT( decode(&tiny) == document );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(2), tiny.size() );
+    }
+
+    void test_outlivesTable()
+    {
+        std::unique_ptr<KeyTable> table(new KeyTable);
+        Value v = decode(table.get());
+        table.reset();
+        CPPUNIT_ASSERT( v == document );
+        v = Value();
+    }
+
+    void test_sharedTable()
+    {
+        KeyTable table(true);
+        std::vector<Value> decoded(4);
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i < decoded.size(); ++i)
+            threads.emplace_back([&, i]{
+                for(int round = 0; round < 5; ++round)
+                    decoded[i] = decode(&table);
+            });
+        for(auto& t : threads)
+            t.join();
+
+        for(const Value& v : decoded)
+            CPPUNIT_ASSERT( v == document );
+        KeyTable alone;
+        decode(&alone);
+        CPPUNIT_ASSERT_EQUAL( alone.size(), table.size() );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Key_Table_Test );
@@ -0,0 +1,163 @@
+#include "value.hpp"
+#include "lazy_value.hpp"
+#include "../test_utils/format_helpers.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <algorithm>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_lazy_value_test = 0;
+
+class Lazy_Value_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Lazy_Value_Test );
+    CPPUNIT_TEST( test_access );
+    CPPUNIT_TEST( test_iteration );
+    CPPUNIT_TEST( test_materialize );
+    CPPUNIT_TEST( test_forwardBytes );
+    CPPUNIT_TEST( test_lazyErrors );
+    CPPUNIT_TEST( test_duplicateKeys );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        document = sample_document();
+        document["id"] = -42;
+        document["tags"] = {"a", "b", "c"};
+        encoded = encode(document);
+    }
+private:
+    Value document;
+    std::string encoded;
+
+    static ByteSpan span_of(const std::string& s)
+    { return ByteSpan(reinterpret_cast<const byte*>(s.data()), s.size()); }
+
+    //! an Object of Int8 items, one for each of \a keys; each item is its index
+    static std::string object_of(const std::vector<std::string>& keys)
+    {
+        std::string rtn("{I");
+        rtn += char(keys.size());
+        for(std::size_t i = 0; i < keys.size(); ++i)
+            rtn += char(keys[i].size()) + keys[i] + 'i' + char(i);
+        return rtn + '}';
+    }
+public:
+
+    void test_access()
+    {
+        LazyValue doc(span_of(encoded));
+        CPPUNIT_ASSERT( doc.isMap() );
+        CPPUNIT_ASSERT_EQUAL( document.size(), doc.size() );
+        CPPUNIT_ASSERT( doc.contains("id") );
+        CPPUNIT_ASSERT( not doc.contains("nope") );
+        CPPUNIT_ASSERT_EQUAL( -42ll, doc["id"].asInt64() );
+        CPPUNIT_ASSERT( doc["tags"].isArray() );
+        CPPUNIT_ASSERT_EQUAL( std::string("b"), doc["tags"][1].asString() );
+        CPPUNIT_ASSERT_EQUAL( document["location"]["latitude"]["relative"].asFloat(),
+                              doc["location"]["latitude"]["relative"].asFloat() );
+
+        Value::Keys expected = document.keys(), keys = doc.keys();
+        std::sort(expected.begin(), expected.end());
+        std::sort(keys.begin(), keys.end());
+        CPPUNIT_ASSERT( expected == keys );
+
+        CPPUNIT_ASSERT_THROW( doc["nope"], std::out_of_range );
+        CPPUNIT_ASSERT_THROW( doc["tags"][3], std::out_of_range );
+        CPPUNIT_ASSERT_THROW( doc[0], value_exception );
+        CPPUNIT_ASSERT_THROW( doc["id"]["x"], value_exception );
+    }
+
+    void test_iteration()
+    {
+        LazyValue doc(span_of(encoded));
+        std::size_t n = 0;
+        for(auto it = doc.begin(); it != doc.end(); ++it, ++n)
+            CPPUNIT_ASSERT( it->value() == document[it.key().str()] );
+        CPPUNIT_ASSERT_EQUAL( doc.size(), n );
+
+        std::string tags;
+        for(const LazyValue& t : doc["tags"])
+            tags += t.asString();
+        CPPUNIT_ASSERT_EQUAL( std::string("abc"), tags );
+    }
+
+    void test_materialize()
+    {
+        LazyValue doc(span_of(encoded));
+        CPPUNIT_ASSERT( doc.value() == document );
+        CPPUNIT_ASSERT( doc["arrays"].value() == document["arrays"] );
+        CPPUNIT_ASSERT( doc["arrays"][2]["location"].value() == document["arrays"][2]["location"] );
+
+        const std::string hinted_bytes = encode(document, StreamWriterOptions{true});
+        LazyValue hinted(span_of(hinted_bytes));
+        CPPUNIT_ASSERT( hinted.value() == document );
+        CPPUNIT_ASSERT( hinted["arrays"][1]["faves"].value() == document["arrays"][1]["faves"] );
+    }
+
+    void test_forwardBytes()
+    {
+        //trailing documents are not part of the first
+        Value next;
+        next["k"] = 1;
+        const std::string two = encoded + encode(next);
+        LazyValue doc(span_of(two));
+        CPPUNIT_ASSERT_EQUAL( encoded.size(), doc.bytes().size() );
+
+        //a member's bytes are its marker and payload; forwarded as is, they decode back to the member
+        ByteSpan fwd = doc["location"].bytes();
+        CPPUNIT_ASSERT_EQUAL( encode(document["location"]).size(), fwd.size() );
+        LazyValue reparsed(fwd);
+        CPPUNIT_ASSERT( reparsed.value() == document["location"] );
+    }
+
+    void test_lazyErrors()
+    {
+        CPPUNIT_ASSERT_THROW( LazyValue(span_of(encoded.substr(0, encoded.size() - 1))), parsing_exception );
+        CPPUNIT_ASSERT_THROW( LazyValue(span_of(std::string("[]"))), parsing_exception );
+        CPPUNIT_ASSERT_THROW( LazyValue{ByteSpan()}, parsing_exception );
+
+        //the shallow scan still walks every subtree, so corruption anywhere is caught upfront
+        std::string bytes = encoded;
+        bytes[bytes.find("relative") + 8] = '?';
+        CPPUNIT_ASSERT_THROW( LazyValue(span_of(bytes)), parsing_exception );
+
+        //unless Width hints let it step over Objects whole; corruption below them shows on access
+        std::string hinted = encode(document, StreamWriterOptions{true});
+        hinted[hinted.find("relative") + 8] = '?';
+        LazyValue doc(span_of(hinted));
+        CPPUNIT_ASSERT_THROW( doc["location"]["latitude"], parsing_exception );
+    }
+
+    void test_duplicateKeys()
+    {
+        //only the last of each repeated key is kept, where it stands, as in Value
+        const std::string few = object_of({"b", "a", "c", "b", "d"});
+        LazyValue doc(span_of(few));
+        CPPUNIT_ASSERT_EQUAL( doc.value().size(), doc.size() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(4), doc.size() );
+        CPPUNIT_ASSERT( doc.keys() == Value::Keys({"a", "c", "b", "d"}) );
+        CPPUNIT_ASSERT_EQUAL( 3, doc["b"].asInt() );
+
+        //past a handful of items, they are sorted by key to find the repeats
+        std::vector<std::string> keys;
+        for(int round = 0; round < 3; ++round)
+            for(int k = 0; k < 10; ++k)
+                keys.push_back("key" + std::to_string(k));
+        keys.push_back("");
+        keys.push_back("");
+        const std::string many = object_of(keys);
+        LazyValue big(span_of(many));
+        CPPUNIT_ASSERT_EQUAL( big.value().size(), big.size() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(11), big.size() );
+        std::size_t n = 0;
+        for(auto it = big.begin(); it != big.end(); ++it, ++n)
+            CPPUNIT_ASSERT( it->value() == big.value()[it.key().str()] );
+        CPPUNIT_ASSERT_EQUAL( big.size(), n );
+        CPPUNIT_ASSERT_EQUAL( 20, big["key0"].asInt() );
+        CPPUNIT_ASSERT_EQUAL( 31, big[""].asInt() );
+        CPPUNIT_ASSERT_EQUAL( std::string("key0"), big.keys().front() );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Lazy_Value_Test );
@@ -0,0 +1,87 @@
+#include "value.hpp"
+#include "mapped_file.hpp"
+#include "../test_utils/format_helpers.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <cstdio>
+#include <fstream>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_mapped_file_test = 0;
+
+class Mapped_File_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Mapped_File_Test );
+    CPPUNIT_TEST( test_documents );
+    CPPUNIT_TEST( test_emptyFile );
+    CPPUNIT_TEST( test_truncatedFile );
+    CPPUNIT_TEST( test_missingFile );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        document = sample_document();
+        second["id"] = 2;
+    }
+
+    void tearDown() override
+    {
+        std::remove(path);
+    }
+private:
+    const char* path = "mapped_file_test.ubex";
+    Value document;
+    Value second;
+
+    void write_file(const std::string& bytes)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(bytes.data(), bytes.size());
+    }
+public:
+
+    void test_documents()
+    {
+        write_file(encode(document) + encode(second) + encode(document));
+
+        MappedFileReader reader(path);
+        Value v1, v2, v3;
+        CPPUNIT_ASSERT( not reader.atEnd() );
+        CPPUNIT_ASSERT( reader.getNextValue(v1) );
+        CPPUNIT_ASSERT( reader.getNextValue(v2) );
+        CPPUNIT_ASSERT( reader.getNextValue(v3) );
+        CPPUNIT_ASSERT( reader.atEnd() );
+        CPPUNIT_ASSERT( v1 == document );
+        CPPUNIT_ASSERT( v2 == second );
+        CPPUNIT_ASSERT( v3 == document );
+    }
+
+    void test_emptyFile()
+    {
+        write_file("");
+        MappedFileReader reader(path);
+        CPPUNIT_ASSERT( reader.atEnd() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), reader.getFile().size() );
+    }
+
+    void test_truncatedFile()
+    {
+        const std::string bytes = encode(document) + encode(second);
+        write_file(bytes.substr(0, bytes.size() - 2));
+
+        MappedFileReader reader(path);
+        Value v1, v2;
+        CPPUNIT_ASSERT( reader.getNextValue(v1) );
+        CPPUNIT_ASSERT( v1 == document );
+        CPPUNIT_ASSERT( not reader.getNextValue(v2) );
+        CPPUNIT_ASSERT( not reader.getLastError().empty() );
+    }
+
+    void test_missingFile()
+    {
+        CPPUNIT_ASSERT_THROW( MappedFileReader reader("no/such/file.ubex"), std::system_error );
+    }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Mapped_File_Test );
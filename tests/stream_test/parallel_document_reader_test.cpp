@@ -0,0 +1,101 @@
+#include "value.hpp"
+#include "parallel_document_reader.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <set>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_parallel_document_reader_test = 0;
+
+class Parallel_Document_Reader_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Parallel_Document_Reader_Test );
+    CPPUNIT_TEST( test_ordered );
+    CPPUNIT_TEST( test_unordered );
+    CPPUNIT_TEST( test_malformedDocument );
+    CPPUNIT_TEST( test_stopEarly );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        records.clear();
+        log.clear();
+        //enough records for many batches; every 100th one carries a large binary
+        for(int i = 0; i < 2000; ++i)
+        {
+            Value record;
+            record["seq"] = i;
+            record["name"] = "record";
+            if(i % 100 == 0)
+                record["blob"] = Value::BinaryType(40000, static_cast<byte>(i));
+            log += encode(record);
+            records.push_back(std::move(record));
+        }
+    }
+private:
+    std::vector<Value> records;
+    std::string log;
+
+    ByteSpan span() const
+    { return ByteSpan(reinterpret_cast<const byte*>(log.data()), log.size()); }
+public:
+
+    void test_ordered()
+    {
+        for(std::size_t threads : {1, 4})
+        {
+            ParallelDocumentReader reader(span(), ParallelReaderOptions{threads, true});
+            CPPUNIT_ASSERT_EQUAL( threads, reader.threads() );
+            Value v;
+            std::size_t n = 0;
+            while(reader.next(v))
+                CPPUNIT_ASSERT( v == records[n++] );
+            CPPUNIT_ASSERT_EQUAL( records.size(), n );
+            CPPUNIT_ASSERT( not reader.failed() );
+            CPPUNIT_ASSERT( not reader.next(v) );
+        }
+    }
+
+    void test_unordered()
+    {
+        ParallelDocumentReader reader(span(), ParallelReaderOptions{3, false});
+        Value v;
+        std::set<long long> seen;
+        while(reader.next(v))
+        {
+            CPPUNIT_ASSERT( v == records[static_cast<std::size_t>(v["seq"].asInt64())] );
+            seen.insert(v["seq"].asInt64());
+        }
+        CPPUNIT_ASSERT_EQUAL( records.size(), seen.size() );
+        CPPUNIT_ASSERT( not reader.failed() );
+    }
+
+    void test_malformedDocument()
+    {
+        //the last record loses its end marker; every one before it still comes back, in order
+        const std::string bytes = log.substr(0, log.size() - 1);
+        ByteSpan s(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+        ParallelDocumentReader reader(s, ParallelReaderOptions{2, true});
+        Value v;
+        std::size_t n = 0;
+        while(reader.next(v))
+            ++n;
+        CPPUNIT_ASSERT_EQUAL( records.size() - 1, n );
+        CPPUNIT_ASSERT( reader.failed() );
+
+        ParallelDocumentReader empty(ByteSpan(), ParallelReaderOptions{2, true});
+        CPPUNIT_ASSERT( not empty.next(v) );
+        CPPUNIT_ASSERT( not empty.failed() );
+    }
+
+    void test_stopEarly()
+    {
+        //destroying the reader midway joins its threads, however much is still queued
+        ParallelDocumentReader reader(span(), ParallelReaderOptions{4, true});
+        Value v;
+        CPPUNIT_ASSERT( reader.next(v) );
+        CPPUNIT_ASSERT( v == records[0] );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Parallel_Document_Reader_Test );
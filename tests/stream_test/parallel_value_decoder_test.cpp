@@ -0,0 +1,133 @@
+#include "value.hpp"
+#include "parallel_value_decoder.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_parallel_value_decoder_test = 0;
+
+class Parallel_Value_Decoder_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Parallel_Value_Decoder_Test );
+    CPPUNIT_TEST( test_largeArrays );
+    CPPUNIT_TEST( test_smallArrays );
+    CPPUNIT_TEST( test_malformedItems );
+    CPPUNIT_TEST( test_depthPolicy );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        capture = Value();
+        for(int i = 0; i < 3000; ++i)
+        {
+            //items of every kind, so the Array is written with a marker per item
+            Value sample;
+            sample["t"] = i;
+            sample["tags"] = Value({"a", i % 7});
+            capture["samples"].push_back(i % 3 == 0 ? sample : i % 3 == 1 ? Value(i * 0.5) : Value("s" + std::to_string(i)));
+            capture["floats"].push_back(i * 0.25);
+            capture["names"].push_back("name" + std::to_string(i));
+        }
+        capture["meta"]["source"] = "probe";
+        capture["short"] = Value({1, 2, 3});
+        bytes = encode(capture);
+    }
+private:
+    Value capture;
+    std::string bytes;
+
+    ByteSpan span() const
+    { return ByteSpan(reinterpret_cast<const byte*>(bytes.data()), bytes.size()); }
+
+    Value sequential(const ValueSizePolicy& policy = defaultStreamReaderPolicy()) const
+    {
+        ByteSpan s = span();
+        BufferReader reader(s, policy);
+        return reader.getNextValue();
+    }
+public:
+
+    void test_largeArrays()
+    {
+        const Value expected = sequential();
+        CPPUNIT_ASSERT( expected == capture );
+        for(std::size_t threads : {1, 2, 5})
+        {
+            ParallelValueDecoder decoder(ParallelDecodeOptions{threads, 100});
+            CPPUNIT_ASSERT_EQUAL( threads, decoder.threads() );
+            Value v;
+            CPPUNIT_ASSERT( decoder.decode(span(), v) );
+            CPPUNIT_ASSERT( v == expected );
+            CPPUNIT_ASSERT_EQUAL( bytes.size(), decoder.getBytesRead() );
+        }
+    }
+
+    void test_smallArrays()
+    {
+        //below the threshold, every Array stays on the calling thread
+        ParallelValueDecoder decoder(ParallelDecodeOptions{4, 5000});
+        Value v;
+        CPPUNIT_ASSERT( decoder.decode(span(), v) );
+        CPPUNIT_ASSERT( v == capture );
+
+        Value nothing;
+        nothing["none"] = Value();
+        const std::string empty = encode(nothing);
+        CPPUNIT_ASSERT( decoder.decode(ByteSpan(reinterpret_cast<const byte*>(empty.data()), empty.size()), v) );
+        CPPUNIT_ASSERT( v == nothing );
+    }
+
+    void test_malformedItems()
+    {
+        //an unknown marker halfway through the name strings
+        const std::string needle = "name1500";
+        std::string corrupt = bytes;
+        const std::size_t at = corrupt.find(needle);
+        CPPUNIT_ASSERT( at != std::string::npos );
+        corrupt[at + needle.size()] = '?';
+        ByteSpan s(reinterpret_cast<const byte*>(corrupt.data()), corrupt.size());
+        BufferReader reader(s);
+        Value v;
+        CPPUNIT_ASSERT( not reader.getNextValue(v) );
+
+        ParallelValueDecoder decoder(ParallelDecodeOptions{3, 100});
+        Value untouched("untouched");
+        CPPUNIT_ASSERT( not decoder.decode(s, untouched) );
+        CPPUNIT_ASSERT( not decoder.getLastError().empty() );
+        CPPUNIT_ASSERT( untouched == Value("untouched") );
+
+        CPPUNIT_ASSERT( not decoder.decode(span().subspan(0, bytes.size() - 1), untouched) );
+        CPPUNIT_ASSERT( not decoder.decode(span().subspan(1), untouched) );
+        CPPUNIT_ASSERT( untouched == Value("untouched") );
+
+        //{ count:1 "a":( type:0x00 count:4 ... ) }; no marker is 0, so items can't share it
+        const std::string zero_typed("{I\x01\x01" "a(\x00I\x04ZZZZ)}", 15);
+        ByteSpan z(reinterpret_cast<const byte*>(zero_typed.data()), zero_typed.size());
+        BufferReader zero_reader(z);
+        CPPUNIT_ASSERT( not zero_reader.getNextValue(v) );
+        ByteSpan zero_span(reinterpret_cast<const byte*>(zero_typed.data()), zero_typed.size());
+        ParallelValueDecoder eager(ParallelDecodeOptions{2, 2});
+        CPPUNIT_ASSERT( not eager.decode(zero_span, untouched) );
+        CPPUNIT_ASSERT_EQUAL( zero_reader.getLastError(), eager.getLastError() );
+        CPPUNIT_ASSERT( untouched == Value("untouched") );
+    }
+
+    void test_depthPolicy()
+    {
+        //the samples' tags nest 4 deep, counting the document itself
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+        for(std::size_t depth : {3, 4})
+        {
+            policy.max_value_depth = depth;
+            Value v;
+            ByteSpan s = span();
+            BufferReader reader(s, policy);
+            ParallelValueDecoder decoder(ParallelDecodeOptions{2, 100}, policy);
+            const bool accepted = reader.getNextValue(v);
+            CPPUNIT_ASSERT_EQUAL( depth == 4, accepted );
+            CPPUNIT_ASSERT_EQUAL( accepted, decoder.decode(span(), v) );
+        }
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Parallel_Value_Decoder_Test );
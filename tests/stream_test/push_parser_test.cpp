@@ -0,0 +1,246 @@
+#include "value.hpp"
+#include "push_parser.hpp"
+#include "validate.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <random>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_push_parser_test = 0;
+
+class Push_Parser_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Push_Parser_Test );
+    CPPUNIT_TEST( test_fragments );
+    CPPUNIT_TEST( test_socketPair );
+    CPPUNIT_TEST( test_agreesWithReader );
+    CPPUNIT_TEST( test_policyLimits );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        documents.clear();
+        for(int i = 0; i < 20; ++i)
+        {
+            Value v = sample_document();
+            v["seq"] = i;
+            for(int k = 0; k < i * 100; ++k)
+                v["samples"].push_back(k * 0.5);
+            v["blob"] = std::string(i * 37, 'x');
+            documents.push_back(std::move(v));
+        }
+    }
+private:
+    std::vector<Value> documents;
+
+    static ByteSpan span(const std::string& s)
+    { return ByteSpan(reinterpret_cast<const byte*>(s.data()), s.size()); }
+
+    static bool decodes(const std::string& s)
+    {
+        ByteSpan bytes = span(s);
+        BufferReader reader(bytes);
+        Value v;
+        return reader.getNextValue(v);
+    }
+
+    //! feeds \a bytes whole, returning what the parser made of them
+    static PushParser::Status feed_all(PushParser& parser, const std::string& bytes)
+    {
+        return parser.feed(span(bytes)).status;
+    }
+
+public:
+
+    void test_fragments()
+    {
+        for(bool hints : {false, true})
+        {
+            const std::string doc = encode(documents[3], StreamWriterOptions{hints});
+            PushParser parser;
+
+            PushParser::Progress p = parser.feed(span(doc));
+            CPPUNIT_ASSERT_EQUAL( PushParser::Complete, p.status );
+            CPPUNIT_ASSERT_EQUAL( doc.size(), p.consumed );
+            CPPUNIT_ASSERT( parser.value() == documents[3] );
+
+            //a byte at a time
+            for(std::size_t i = 0; i < doc.size(); ++i)
+            {
+                p = parser.feed(span(doc.substr(i, 1)));
+                CPPUNIT_ASSERT_EQUAL( std::size_t(1), p.consumed );
+                CPPUNIT_ASSERT_EQUAL( i + 1 == doc.size() ? PushParser::Complete : PushParser::NeedMore, p.status );
+            }
+            CPPUNIT_ASSERT( parser.take() == documents[3] );
+
+            //several documents in one fragment; each feed stops at the end of one
+            const std::string three = doc + doc + doc;
+            ByteSpan rest = span(three);
+            for(int i = 0; i < 3; ++i)
+            {
+                p = parser.feed(rest);
+                CPPUNIT_ASSERT_EQUAL( PushParser::Complete, p.status );
+                CPPUNIT_ASSERT_EQUAL( doc.size(), p.consumed );
+                CPPUNIT_ASSERT_EQUAL( doc.size(), parser.getBytesRead() );
+                CPPUNIT_ASSERT( parser.value() == documents[3] );
+                rest = rest.subspan(p.consumed);
+            }
+            CPPUNIT_ASSERT( rest.empty() );
+            CPPUNIT_ASSERT_EQUAL( PushParser::NeedMore, parser.feed(rest).status );
+        }
+    }
+
+    void test_socketPair()
+    {
+        int fds[2];
+        CPPUNIT_ASSERT_EQUAL( 0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) );
+        CPPUNIT_ASSERT( ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK) == 0 );
+
+        std::string wire;
+        for(std::size_t i = 0; i < documents.size(); ++i)
+            wire += encode(documents[i], StreamWriterOptions{i % 2 == 1});
+
+        //the sender splits the wire at random, the receiver reads it in random sizes
+        std::thread sender([&]{
+            std::mt19937 rng(2015);
+            std::size_t sent = 0;
+            while(sent < wire.size())
+            {
+                const std::size_t sz = std::min<std::size_t>(wire.size() - sent, rng() % 300 + 1);
+                const ssize_t n = ::send(fds[1], wire.data() + sent, sz, 0);
+                if(n > 0)
+                    sent += static_cast<std::size_t>(n);
+                if(rng() % 8 == 0)
+                    std::this_thread::yield();
+            }
+            ::close(fds[1]);
+        });
+
+        std::mt19937 rng(1960);
+        PushParser parser;
+        std::size_t received = 0, calls = 0;
+        bool failed = false;
+        byte buf[512];
+        for(;;)
+        {
+            const ssize_t n = ::recv(fds[0], buf, rng() % sizeof buf + 1, 0);
+            if(n == 0)
+                break;
+            if(n < 0)
+            {
+                pollfd pfd{fds[0], POLLIN, 0};
+                ::poll(&pfd, 1, 1000);
+                continue;
+            }
+
+            ++calls;
+            ByteSpan bytes(buf, static_cast<std::size_t>(n));
+            while(not bytes.empty())
+            {
+                const PushParser::Progress p = parser.feed(bytes);
+                bytes = bytes.subspan(p.consumed);
+                if(p.status == PushParser::Complete)
+                    failed |= not (received < documents.size() and parser.take() == documents[received++]);
+                else if(p.status == PushParser::Error)
+                {
+                    failed = true;
+                    break;
+                }
+            }
+        }
+        sender.join();
+        ::close(fds[0]);
+
+        CPPUNIT_ASSERT( not failed );
+        CPPUNIT_ASSERT_EQUAL( documents.size(), received );
+        CPPUNIT_ASSERT( calls > documents.size() );
+    }
+
+    void test_agreesWithReader()
+    {
+        //sample_document() has no homogenous Arrays, so their headers get mutated too
+        Value homogenous;
+        homogenous["ints"] = {1, 2, 3, 300};
+        homogenous["floats"] = {1.5, -2.25};
+        homogenous["names"] = {"ab", "cd", "ef"};
+        homogenous["nested"] = {Value{7, 8}, Value{"x", "y"}};
+
+        PushParser parser;
+        for(const Value& source : {sample_document(), homogenous})
+        {
+            const std::string doc = encode(source);
+            for(std::size_t i = 0; i < doc.size(); ++i)
+            {
+                CPPUNIT_ASSERT_EQUAL( PushParser::NeedMore, feed_all(parser, doc.substr(0, i)) );
+                parser.reset();
+
+                for(char c : {'\0', 'I', 'K', 's', '[', ']', '(', ')', '{', '}', 'W', '\xff'})
+                {
+                    std::string mutated = doc;
+                    mutated[i] = c;
+                    const PushParser::Status status = feed_all(parser, mutated);
+                    const ParseResult checked = validate(span(mutated));
+                    if(decodes(mutated))
+                        CPPUNIT_ASSERT_EQUAL( PushParser::Complete, status );
+                    else if(checked.code == ParseError::UnexpectedEnd)
+                        CPPUNIT_ASSERT_EQUAL( PushParser::NeedMore, status );
+                    else
+                    {
+                        CPPUNIT_ASSERT_EQUAL( PushParser::Error, status );
+                        CPPUNIT_ASSERT( parser.error().code == checked.code or checked.code == ParseError::WidthMismatch );
+                        CPPUNIT_ASSERT_EQUAL( PushParser::Error, feed_all(parser, doc) );
+                    }
+                    parser.reset();
+                }
+            }
+        }
+
+        //{ count:2 "a":'?'
+        CPPUNIT_ASSERT_EQUAL( PushParser::Error, feed_all(parser, std::string("{I\x02\x01" "a?", 6)) );
+        CPPUNIT_ASSERT( parser.error().code == ParseError::UnknownMarker );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(5), parser.error().offset );
+        CPPUNIT_ASSERT_EQUAL( std::string("Unknown value marker encountered!"), parser.getLastError() );
+        parser.reset();
+
+        //{ count:1 "k":( type:0x00 count:1 ... ) }; no marker is 0, so items can't share it
+        const std::string zero_typed("{I\x01\x01" "k(\x00I\x01Z)}", 12);
+        CPPUNIT_ASSERT_EQUAL( PushParser::Error, feed_all(parser, zero_typed) );
+        CPPUNIT_ASSERT( parser.error().code == ParseError::UnknownMarker );
+        CPPUNIT_ASSERT( validate(span(zero_typed)).code == ParseError::UnknownMarker );
+        CPPUNIT_ASSERT( not decodes(zero_typed) );
+    }
+
+    void test_policyLimits()
+    {
+        const std::string doc = encode(documents[10]);
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+        policy.max_object_size = doc.size() - 1;
+        PushParser limited(policy);
+
+        PushParser::Progress p{PushParser::NeedMore, 0};
+        for(std::size_t i = 0; i < doc.size() and p.status == PushParser::NeedMore; i += 100)
+            p = limited.feed(span(doc.substr(i, 100)));
+        CPPUNIT_ASSERT_EQUAL( PushParser::Error, p.status );
+        CPPUNIT_ASSERT( limited.error().code == ParseError::ObjectTooLarge );
+
+        policy = defaultStreamReaderPolicy();
+        policy.max_value_depth = 4;
+        PushParser shallow(policy);
+        CPPUNIT_ASSERT_EQUAL( PushParser::Error, feed_all(shallow, doc) );
+        CPPUNIT_ASSERT( shallow.error().code == ParseError::TooDeep );
+
+        policy = defaultStreamReaderPolicy();
+        policy.max_string_size = 12;
+        PushParser strict(policy);
+        CPPUNIT_ASSERT_EQUAL( PushParser::Error, feed_all(strict, doc) );
+        CPPUNIT_ASSERT( strict.error().code == ParseError::StringTooLarge );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Push_Parser_Test );
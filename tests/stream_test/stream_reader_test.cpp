@@ -0,0 +1,476 @@
+#include "value.hpp"
+#include "stream_reader.hpp"
+#include "../test_utils/format_helpers.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <limits>
+#include <sstream>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_stream_reader_test = 0;
+
+class Stream_Reader_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Stream_Reader_Test );
+    CPPUNIT_TEST( test_roundTrip );
+    CPPUNIT_TEST( test_bufferSizes );
+    CPPUNIT_TEST( test_consecutiveValues );
+    CPPUNIT_TEST( test_truncatedStream );
+    CPPUNIT_TEST( test_bufferReader );
+    CPPUNIT_TEST( test_bufferReaderBounds );
+    CPPUNIT_TEST( test_sequencePolicy );
+    CPPUNIT_TEST( test_valueIsReplaced );
+    CPPUNIT_TEST( test_deepNesting );
+    CPPUNIT_TEST( test_scalarWidths );
+    CPPUNIT_TEST( test_widthHints );
+    CPPUNIT_TEST( test_numericArrays );
+    CPPUNIT_TEST( test_homogenousArrays );
+    CPPUNIT_TEST( test_tryParse );
+    CPPUNIT_TEST( test_staticPolicies );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        document = sample_document();
+        encoded = encode(document);
+    }
+private:
+    Value document;
+    std::string encoded;
+public:
+
+    void test_roundTrip()
+    {
+        std::istringstream ss(encoded);
+        StreamReader<std::istringstream> reader(ss);
+        Value v;
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v == document );
+        CPPUNIT_ASSERT_EQUAL( encoded.size(), reader.getBytesRead() );
+    }
+
+    void test_bufferSizes()
+    {
+        for(std::size_t buffer_size : {0, 1, 2, 7, 64, 4096})
+        {
+            std::istringstream ss(encoded);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            Value v;
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+        }
+    }
+
+    void test_consecutiveValues()
+    {
+        Value second;
+        second["id"] = 2;
+        std::istringstream ss(encoded + encode(second));
+        StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), 16);
+
+        Value v1, v2, v3;
+        CPPUNIT_ASSERT( reader.getNextValue(v1) );
+        CPPUNIT_ASSERT( v1 == document );
+        CPPUNIT_ASSERT( not reader.atEnd() );
+        CPPUNIT_ASSERT( reader.getNextValue(v2) );
+        CPPUNIT_ASSERT( v2 == second );
+        CPPUNIT_ASSERT( reader.atEnd() );
+        CPPUNIT_ASSERT( not reader.getNextValue(v3) );
+    }
+
+    void test_truncatedStream()
+    {
+        std::istringstream ss(encoded.substr(0, encoded.size() / 2));
+        StreamReader<std::istringstream> reader(ss);
+        Value v;
+        CPPUNIT_ASSERT( not reader.getNextValue(v) );
+        CPPUNIT_ASSERT( not reader.getLastError().empty() );
+
+        //short reads are caught as they happen, unbuffered ones included
+        for(std::size_t buffer_size : {0, 7, 4096})
+            for(std::size_t size = 1; size < encoded.size(); size += 13)
+            {
+                std::istringstream ss(encoded.substr(0, size));
+                StreamReader<std::istringstream> truncated(ss, defaultStreamReaderPolicy(), buffer_size);
+                CPPUNIT_ASSERT( not truncated.getNextValue(v) );
+                CPPUNIT_ASSERT( truncated.getLastErrorCode() == ParseError::UnexpectedEnd );
+            }
+    }
+
+    void test_bufferReader()
+    {
+        Value second;
+        second["id"] = 2;
+        const std::string both = encoded + encode(second);
+        ByteSpan span(reinterpret_cast<const byte*>(both.data()), both.size());
+        BufferReader reader(span);
+
+        Value v1, v2, v3;
+        CPPUNIT_ASSERT( reader.getNextValue(v1) );
+        CPPUNIT_ASSERT( v1 == document );
+        CPPUNIT_ASSERT_EQUAL( encoded.size(), reader.getBytesRead() );
+        CPPUNIT_ASSERT( reader.getNextValue(v2) );
+        CPPUNIT_ASSERT( v2 == second );
+        CPPUNIT_ASSERT( not reader.getNextValue(v3) );
+    }
+
+    void test_bufferReaderBounds()
+    {
+        ByteSpan span(reinterpret_cast<const byte*>(encoded.data()), encoded.size() - 1);
+        BufferReader truncated(span);
+        Value v;
+        CPPUNIT_ASSERT( not truncated.getNextValue(v) );
+
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+        policy.max_object_size = encoded.size() - 1;
+        ByteSpan whole(reinterpret_cast<const byte*>(encoded.data()), encoded.size());
+        BufferReader limited(whole, policy);
+        CPPUNIT_ASSERT( not limited.getNextValue(v) );
+
+        policy.max_object_size = encoded.size();
+        BufferReader allowed(whole, policy);
+        Value v2;
+        CPPUNIT_ASSERT( allowed.getNextValue(v2) );
+        CPPUNIT_ASSERT( v2 == document );
+    }
+
+    void test_sequencePolicy()
+    {
+        Value v;
+        v["text"] = std::string(100, 'x');
+        v["blob"] = Value::BinaryType(200, 0x7f);
+        const std::string bytes = encode(v);
+        ByteSpan span(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+        policy.max_string_size = 99;
+        BufferReader short_strings(span, policy);
+        Value v1;
+        CPPUNIT_ASSERT( not short_strings.getNextValue(v1) );
+
+        policy.max_string_size = 100;
+        policy.max_binary_size = 199;
+        BufferReader short_blobs(span, policy);
+        Value v2;
+        CPPUNIT_ASSERT( not short_blobs.getNextValue(v2) );
+
+        policy.max_binary_size = 200;
+        std::istringstream ss(bytes);
+        StreamReader<std::istringstream> reader(ss, policy, 16);
+        Value v3;
+        CPPUNIT_ASSERT( reader.getNextValue(v3) );
+        CPPUNIT_ASSERT( v3 == v );
+    }
+
+    void test_valueIsReplaced()
+    {
+        Value second;
+        second["id"] = 2;
+        std::istringstream ss(encoded + encode(second));
+        StreamReader<std::istringstream> reader(ss);
+
+        Value v;
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v == second );
+    }
+
+    void test_deepNesting()
+    {
+        //alternating Objects and Arrays, 1000 levels deep
+        Value deep;
+        deep["leaf"] = true;
+        for(int level = 1; level < 1000; ++level)
+        {
+            Value parent;
+            if(level % 2)
+                parent = {Value(level), std::move(deep)};
+            else
+                parent["next"] = std::move(deep);
+            deep = std::move(parent);
+        }
+        Value document;
+        document["deep"] = std::move(deep);
+        const std::string bytes = encode(document);
+        ByteSpan span(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+
+        BufferReader reader(span);
+        Value v;
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v == document );
+
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+        policy.max_value_depth = 1000;
+        BufferReader shallow(span, policy);
+        CPPUNIT_ASSERT( not shallow.getNextValue(v) );
+        CPPUNIT_ASSERT_EQUAL( std::string("Maximum Parsing depth Exceeded!"), shallow.getLastError() );
+
+        policy.max_value_depth = 1001;
+        BufferReader exact(span, policy);
+        CPPUNIT_ASSERT( exact.getNextValue(v) );
+    }
+
+    void test_scalarWidths()
+    {
+        //the limits of every integer and float width, signed ones must come back sign extended
+        Value scalars = {
+            -128ll, -129ll, -32768ll, -32769ll, -2147483648ll, -2147483649ll,
+            std::numeric_limits<long long>::min(), -1ll,
+            255ull, 256ull, 65535ull, 65536ull, 4294967295ull, 4294967296ull,
+            std::numeric_limits<unsigned long long>::max(),
+            0.5, -1.0e300, 'z', true, false, Value()
+        };
+        Value document;
+        document["scalars"] = scalars;
+        const std::string bytes = encode(document);
+
+        //every buffer size ends the buffered bytes somewhere else within the payloads
+        for(std::size_t buffer_size : {0, 3, 5, 4096})
+        {
+            std::istringstream ss(bytes);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            Value v;
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+        }
+    }
+
+    void test_widthHints()
+    {
+        Value small;
+        small["a"] = 1;
+        const std::string hinted_small = encode(small, StreamWriterOptions{true});
+        CPPUNIT_ASSERT_EQUAL( std::string("{WI\x07I\x01\x01" "aI\x01}"), hinted_small );
+
+        //small buffers make the reader grow its buffer to hold each hinted Object at once
+        const std::string hinted = encode(document, StreamWriterOptions{true});
+        for(std::size_t buffer_size : {0, 16, 4096})
+        {
+            std::istringstream ss(hinted + hinted);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            Value v;
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+            CPPUNIT_ASSERT_EQUAL( hinted.size(), reader.getBytesRead() );
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+        }
+
+        //an empty Object may carry a hint too
+        Value v;
+        std::string empty("{WI\x01}");
+        ByteSpan span(reinterpret_cast<const byte*>(empty.data()), empty.size());
+        BufferReader empty_reader(span);
+        CPPUNIT_ASSERT( empty_reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v.isNull() );
+        CPPUNIT_ASSERT_EQUAL( empty.size(), empty_reader.getBytesRead() );
+
+        //a hint that doesn't even cover the item count
+        std::string lying = hinted_small;
+        lying[3] = 2;
+        span = ByteSpan(reinterpret_cast<const byte*>(lying.data()), lying.size());
+        BufferReader lying_reader(span);
+        CPPUNIT_ASSERT( not lying_reader.getNextValue(v) );
+    }
+
+    //! {"f": (d 1.5 -2.25 3), "i": (j -2 300), "e": (I)}, homogenous Arrays written by hand
+    static std::string homogenous_document()
+    {
+        const char bytes[] = {
+            '{', 'I', 3,
+            1, 'f', '(', 'd', 'I', 3,
+                0x3f, (char)0xc0, 0, 0,   (char)0xc0, 0x10, 0, 0,   0x40, 0x40, 0, 0,   ')',
+            1, 'i', '(', 'j', 'I', 2,
+                (char)0xff, (char)0xfe,   0x01, 0x2c,   ')',
+            1, 'e', '(', 'I', ')',
+            '}'
+        };
+        return std::string(bytes, sizeof(bytes));
+    }
+
+    void test_numericArrays()
+    {
+        Value expected;
+        expected["f"] = {1.5, -2.25, 3.0};
+        expected["i"] = {-2, 300};
+        expected["e"] = Value();
+
+        //items are decoded in bulk, whether they are in place or gathered into scratch
+        const std::string bytes = homogenous_document();
+        for(std::size_t buffer_size : {0, 5, 4096})
+        {
+            std::istringstream ss(bytes);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            Value v;
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == expected );
+            CPPUNIT_ASSERT_EQUAL( bytes.size(), reader.getBytesRead() );
+        }
+
+        //a count the document can't hold
+        std::string bogus = bytes;
+        bogus[bogus.find('j') + 2] = 100;
+        std::istringstream ss(bogus);
+        StreamReader<std::istringstream> reader(ss);
+        Value v;
+        CPPUNIT_ASSERT( not reader.getNextValue(v) );
+    }
+    void test_homogenousArrays()
+    {
+        //Arrays of one type share a single marker of the narrowest width that fits all their items
+        const auto encoded_array = [](const Value& items) {
+            Value v;
+            v["a"] = items;
+            const std::string bytes = encode(v);
+            return bytes.substr(5, bytes.size() - 6);
+        };
+        CPPUNIT_ASSERT_EQUAL( std::string("(iI\x02\xff\x64)"), encoded_array({-1, 100}) );
+        CPPUNIT_ASSERT_EQUAL( std::string("(JI\x02\x01\x2c\x00\x05", 8) + ")", encoded_array({300, 5}) );
+        CPPUNIT_ASSERT_EQUAL( std::string("(dI\x02\x3f\xc0\x00\x00\xc0\x10\x00\x00", 12) + ")", encoded_array({1.5, -2.25}) );
+        CPPUNIT_ASSERT_EQUAL( 'D', encoded_array({1.5, 0.1})[1] );
+        CPPUNIT_ASSERT_EQUAL( std::string("(cI\x02xy)"), encoded_array({'x', 'y'}) );
+        CPPUNIT_ASSERT_EQUAL( std::string("(sI\x02I\x02" "abI\x01" "c)"), encoded_array({"ab", "c"}) );
+        CPPUNIT_ASSERT_EQUAL( '[', encoded_array({1, 'x'})[0] );
+        CPPUNIT_ASSERT_EQUAL( '[', encoded_array({true, false})[0] );
+
+        Value document;
+        document["int8"] = {-128, 127, 0};
+        document["int64"] = {std::numeric_limits<long long>::min(), 1ll};
+        document["uint64"] = {std::numeric_limits<unsigned long long>::max(), 0ull};
+        document["doubles"] = {-1.0e300, 0.1, 2.0};
+        document["binary"] = {Value::BinaryType({0x01, 0x02}), Value::BinaryType({0x03})};
+        Value many;
+        for(int i = 0; i < 1000; ++i)
+            many.push_back(i * 0.25f);
+        document["many"] = std::move(many);
+
+        const std::string bytes = encode(document);
+        for(std::size_t buffer_size : {0, 5, 4096})
+        {
+            std::istringstream ss(bytes);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            Value v;
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+            CPPUNIT_ASSERT_EQUAL( bytes.size(), reader.getBytesRead() );
+        }
+    }
+
+    void test_tryParse()
+    {
+        for(std::size_t buffer_size : {0, 5, 4096})
+        {
+            std::istringstream ss(encoded + encoded);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            for(int i = 0; i < 2; ++i)
+            {
+                Value v;
+                const ParseResult r = reader.tryGetNextValue(v);
+                CPPUNIT_ASSERT( r );
+                CPPUNIT_ASSERT_EQUAL( encoded.size(), r.offset );
+                CPPUNIT_ASSERT( v == document );
+            }
+            Value v;
+            CPPUNIT_ASSERT( reader.tryGetNextValue(v).code == ParseError::UnexpectedEnd );
+
+            std::istringstream cut(encoded.substr(0, encoded.size() - 1));
+            StreamReader<std::istringstream> truncated(cut, defaultStreamReaderPolicy(), buffer_size);
+            const ParseResult r = truncated.tryGetNextValue(v);
+            CPPUNIT_ASSERT( r.code == ParseError::UnexpectedEnd );
+            CPPUNIT_ASSERT( buffer_size == 0 or r.offset == encoded.size() - 1 );
+            CPPUNIT_ASSERT_EQUAL( std::string(r.message()), truncated.getLastError() );
+        }
+
+        //nothing reaches the handler of a malformed Object
+        std::string bogus = encoded;
+        bogus[encoded.size() - 1] = '?';
+        ByteSpan span(reinterpret_cast<const byte*>(bogus.data()), bogus.size());
+        BufferReader reader(span);
+        struct Counter : BasicHandler
+        {
+            int events = 0;
+            void null() { ++events; }
+            void boolean(bool) { ++events; }
+            void int64(long long) { ++events; }
+            void string(StringRef) { ++events; }
+            void startObject(std::size_t) { ++events; }
+        } counter;
+        const ParseResult r = reader.tryParse(counter);
+        CPPUNIT_ASSERT( r.code == ParseError::MissingEnd );
+        CPPUNIT_ASSERT_EQUAL( encoded.size() - 1, r.offset );
+        CPPUNIT_ASSERT_EQUAL( 0, counter.events );
+        CPPUNIT_ASSERT( reader.getLastErrorCode() == ParseError::MissingEnd );
+
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+        policy.max_object_size = encoded.size() - 1;
+        std::istringstream ss(encoded);
+        StreamReader<std::istringstream> limited(ss, policy, 16);
+        Value v;
+        CPPUNIT_ASSERT( limited.tryGetNextValue(v).code == ParseError::ObjectTooLarge );
+    }
+
+    void test_staticPolicies()
+    {
+        for(std::size_t buffer_size : {std::size_t(0), std::size_t(16), defaultReadBufferSize()})
+        {
+            std::istringstream ss(encoded + encoded);
+            StreamReader<std::istringstream, DefaultStaticSizePolicy> fixed(ss, {}, buffer_size);
+            Value v;
+            CPPUNIT_ASSERT( fixed.getNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+            CPPUNIT_ASSERT( fixed.tryGetNextValue(v) );
+            CPPUNIT_ASSERT( v == document );
+        }
+
+        Value v;
+        v["text"] = std::string(100, 'x');
+        v["list"] = {Value(1), Value{Value(2), Value("three")}};
+        const std::string bytes = encode(v);
+        const ByteSpan span(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+        Value got;
+
+        ByteSpan s1 = span;
+        StreamReader<ByteSpan, StaticSizePolicy<3, 1024, 99, 1024>> short_strings(s1);
+        CPPUNIT_ASSERT( not short_strings.getNextValue(got) );
+        CPPUNIT_ASSERT( short_strings.getLastErrorCode() == ParseError::StringTooLarge );
+
+        ByteSpan s2 = span;
+        StreamReader<ByteSpan, StaticSizePolicy<2, 1024, 100, 1024>> shallow(s2);
+        CPPUNIT_ASSERT( not shallow.getNextValue(got) );
+        CPPUNIT_ASSERT( shallow.getLastErrorCode() == ParseError::TooDeep );
+
+        ByteSpan s3 = span;
+        StreamReader<ByteSpan, StaticSizePolicy<3, 1024, 100, 100>> small(s3);
+        CPPUNIT_ASSERT( not small.getNextValue(got) );
+        CPPUNIT_ASSERT( small.getLastErrorCode() == ParseError::ObjectTooLarge );
+
+        ByteSpan s4 = span;
+        StreamReader<ByteSpan, StaticSizePolicy<3, 1024, 100, 1024>> exact(s4);
+        CPPUNIT_ASSERT( exact.getNextValue(got) );
+        CPPUNIT_ASSERT( got == v );
+
+        //past every default limit, yet still wary of malformed Objects
+        Value deep;
+        deep["leaf"] = std::string(9*1024*1024, 'x');
+        for(int level = 1; level < 1500; ++level)
+        {
+            Value parent;
+            parent["next"] = std::move(deep);
+            deep = std::move(parent);
+        }
+        std::string huge = encode(deep);
+        ByteSpan s5(reinterpret_cast<const byte*>(huge.data()), huge.size());
+        StreamReader<ByteSpan, UncheckedSizePolicy> unchecked(s5);
+        CPPUNIT_ASSERT( unchecked.getNextValue(got) );
+        CPPUNIT_ASSERT( got == deep );
+
+        huge.back() = 'x';
+        ByteSpan s6(reinterpret_cast<const byte*>(huge.data()), huge.size());
+        StreamReader<ByteSpan, UncheckedSizePolicy> malformed(s6);
+        CPPUNIT_ASSERT( not malformed.getNextValue(got) );
+        CPPUNIT_ASSERT( malformed.getLastErrorCode() == ParseError::MissingEnd );
+    }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Stream_Reader_Test );
@@ -0,0 +1,245 @@
+#include "value.hpp"
+#include "ubex_cursor.hpp"
+#include "../test_utils/format_helpers.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <sstream>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_ubex_cursor_test = 0;
+
+class Ubex_Cursor_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Ubex_Cursor_Test );
+    CPPUNIT_TEST( test_tokens );
+    CPPUNIT_TEST( test_skip );
+    CPPUNIT_TEST( test_skipHinted );
+    CPPUNIT_TEST( test_readNumbers );
+    CPPUNIT_TEST( test_streamCursor );
+    CPPUNIT_TEST( test_documents );
+    CPPUNIT_TEST( test_error );
+    CPPUNIT_TEST( test_sizePolicies );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        document = sample_document();
+        encoded = encode(document);
+    }
+private:
+    Value document;
+    std::string encoded;
+
+    static ByteSpan span_of(const std::string& s)
+    { return ByteSpan(reinterpret_cast<const byte*>(s.data()), s.size()); }
+
+    //! reads the "id" and "tags" members of a document, skipping everything else
+    template<typename StreamType, typename SizePolicy>
+    static std::pair<long long, std::string> read_id_and_tags(UbexCursor<StreamType, SizePolicy>& cursor)
+    {
+        std::pair<long long, std::string> rtn(0, "");
+        CPPUNIT_ASSERT( cursor.next() == Token::ObjectStart );
+        while(cursor.next() == Token::SignedInt or cursor.token() == Token::UnsignedInt or cursor.isContainerStart()
+              or cursor.token() == Token::String)
+        {
+            if(cursor.key() == "id")
+                rtn.first = cursor.asInt64();
+            else if(cursor.key() == "tags")
+                while(cursor.next() == Token::String)
+                    rtn.second += cursor.asString().str();
+            else
+                CPPUNIT_ASSERT( cursor.skip() );
+        }
+        CPPUNIT_ASSERT( cursor.token() == Token::ObjectEnd );
+        return rtn;
+    }
+public:
+
+    void test_tokens()
+    {
+        Value v;
+        v["list"] = {1, -2, 'x', "yo", true, 2.5};
+        const std::string bytes = encode(v);
+        ByteSpan span = span_of(bytes);
+        BufferReader reader(span);
+        BufferCursor cursor(reader);
+
+        CPPUNIT_ASSERT( cursor.next() == Token::ObjectStart );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), cursor.count() );
+        CPPUNIT_ASSERT( cursor.next() == Token::ArrayStart );
+        CPPUNIT_ASSERT( cursor.key() == "list" );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(6), cursor.count() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(2), cursor.depth() );
+        CPPUNIT_ASSERT( cursor.next() == Token::UnsignedInt );
+        CPPUNIT_ASSERT_EQUAL( 1ull, cursor.asUint64() );
+        CPPUNIT_ASSERT( cursor.next() == Token::SignedInt );
+        CPPUNIT_ASSERT_EQUAL( -2ll, cursor.asInt64() );
+        CPPUNIT_ASSERT( cursor.next() == Token::Char );
+        CPPUNIT_ASSERT_EQUAL( 'x', cursor.asChar() );
+        CPPUNIT_ASSERT( cursor.next() == Token::String );
+        CPPUNIT_ASSERT( cursor.asString() == "yo" );
+        CPPUNIT_ASSERT( cursor.next() == Token::Bool );
+        CPPUNIT_ASSERT( cursor.asBool() );
+        CPPUNIT_ASSERT( cursor.next() == Token::Float );
+        CPPUNIT_ASSERT_EQUAL( 2.5, cursor.asFloat() );
+        CPPUNIT_ASSERT( cursor.next() == Token::ArrayEnd );
+        CPPUNIT_ASSERT( cursor.next() == Token::ObjectEnd );
+        CPPUNIT_ASSERT( cursor.next() == Token::End );
+    }
+
+    void test_skip()
+    {
+        Value v;
+        v["id"] = -42;
+        v["big"] = document;
+        v["tags"] = {"a", "b", "c"};
+        const std::string bytes = encode(v);
+        ByteSpan span = span_of(bytes);
+        BufferReader reader(span);
+        BufferCursor cursor(reader);
+
+        auto result = read_id_and_tags(cursor);
+        CPPUNIT_ASSERT_EQUAL( -42ll, result.first );
+        CPPUNIT_ASSERT_EQUAL( std::string("abc"), result.second );
+        CPPUNIT_ASSERT_EQUAL( bytes.size(), reader.getBytesRead() );
+    }
+
+    void test_skipHinted()
+    {
+        //with Width hints, skipped Objects are stepped over whole; items must still line up after them
+        Value v;
+        v["id"] = -42;
+        v["big"] = document;
+        v["tags"] = {"a", "b", "c"};
+        const std::string bytes = encode(v, StreamWriterOptions{true});
+        for(std::size_t buffer_size : {0, 16})
+        {
+            std::istringstream ss(bytes);
+            StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), buffer_size);
+            UbexCursor<std::istringstream> cursor(reader);
+
+            auto result = read_id_and_tags(cursor);
+            CPPUNIT_ASSERT_EQUAL( -42ll, result.first );
+            CPPUNIT_ASSERT_EQUAL( std::string("abc"), result.second );
+            CPPUNIT_ASSERT_EQUAL( bytes.size(), reader.getBytesRead() );
+        }
+    }
+
+    void test_readNumbers()
+    {
+        //{"f": (d 1.5 -2.25), "s": ["x"]}
+        const byte bytes[] = { '{', 'I', 2,
+                               1, 'f', '(', 'd', 'I', 2, 0x3f, 0xc0, 0, 0, 0xc0, 0x10, 0, 0, ')',
+                               1, 's', '[', 'I', 1, 's', 'I', 1, 'x', ']',
+                               '}' };
+        ByteSpan span(bytes, sizeof(bytes));
+        BufferReader reader(span);
+        BufferCursor cursor(reader);
+
+        std::vector<float> floats;
+        CPPUNIT_ASSERT( cursor.next() == Token::ObjectStart );
+        CPPUNIT_ASSERT( not cursor.readNumbers(floats) );
+        CPPUNIT_ASSERT( cursor.next() == Token::ArrayStart );
+        CPPUNIT_ASSERT( cursor.isNumericArrayStart() );
+        CPPUNIT_ASSERT( cursor.readNumbers(floats) );
+        CPPUNIT_ASSERT( cursor.token() == Token::ArrayEnd );
+        CPPUNIT_ASSERT( floats == std::vector<float>({1.5f, -2.25f}) );
+
+        std::vector<long long> ints;
+        CPPUNIT_ASSERT( cursor.next() == Token::ArrayStart );
+        CPPUNIT_ASSERT( not cursor.isNumericArrayStart() );
+        CPPUNIT_ASSERT( not cursor.readNumbers(ints) );
+        CPPUNIT_ASSERT( cursor.token() == Token::ArrayStart );
+        CPPUNIT_ASSERT( cursor.skip() );
+        CPPUNIT_ASSERT( cursor.next() == Token::ObjectEnd );
+        CPPUNIT_ASSERT_EQUAL( sizeof(bytes), reader.getBytesRead() );
+    }
+
+    void test_streamCursor()
+    {
+        Value v;
+        v["big"] = document;
+        v["id"] = -7;
+        v["tags"] = {"x", "y"};
+        std::istringstream ss(encode(v));
+        StreamReader<std::istringstream> reader(ss, defaultStreamReaderPolicy(), 5);
+        UbexCursor<std::istringstream> cursor(reader);
+
+        auto result = read_id_and_tags(cursor);
+        CPPUNIT_ASSERT_EQUAL( -7ll, result.first );
+        CPPUNIT_ASSERT_EQUAL( std::string("xy"), result.second );
+    }
+
+    void test_documents()
+    {
+        const std::string bytes = encoded + encoded;
+        ByteSpan span = span_of(bytes);
+        BufferReader reader(span);
+        BufferCursor cursor(reader);
+
+        for(int i = 0; i < 2; ++i)
+        {
+            CPPUNIT_ASSERT( cursor.next() == Token::ObjectStart );
+            CPPUNIT_ASSERT( cursor.skip() );
+            CPPUNIT_ASSERT( cursor.token() == Token::ObjectEnd );
+            CPPUNIT_ASSERT_EQUAL( std::size_t(0), cursor.depth() );
+        }
+        CPPUNIT_ASSERT( cursor.next() == Token::End );
+    }
+
+    void test_error()
+    {
+        const std::string bytes = encoded.substr(0, encoded.size() - 3);
+        ByteSpan span = span_of(bytes);
+        BufferReader reader(span);
+        BufferCursor cursor(reader);
+
+        CPPUNIT_ASSERT( cursor.next() == Token::ObjectStart );
+        CPPUNIT_ASSERT( not cursor.skip() );
+        CPPUNIT_ASSERT( cursor.token() == Token::Error );
+        CPPUNIT_ASSERT( cursor.next() == Token::Error );
+        CPPUNIT_ASSERT( not cursor.getLastError().empty() );
+    }
+
+    void test_sizePolicies()
+    {
+        //a cursor over an unchecked reader steps through the same tokens
+        ByteSpan span = span_of(encoded);
+        BufferReader reader(span);
+        BufferCursor cursor(reader);
+        ByteSpan unchecked_span = span_of(encoded);
+        StreamReader<ByteSpan, UncheckedSizePolicy> unchecked_reader(unchecked_span);
+        UbexCursor<ByteSpan, UncheckedSizePolicy> unchecked(unchecked_reader);
+        std::size_t tokens = 0;
+        while(cursor.next() != Token::End)
+        {
+            CPPUNIT_ASSERT( unchecked.next() == cursor.token() );
+            CPPUNIT_ASSERT( unchecked.key() == cursor.key() );
+            CPPUNIT_ASSERT_EQUAL( cursor.depth(), unchecked.depth() );
+            ++tokens;
+        }
+        CPPUNIT_ASSERT( unchecked.next() == Token::End );
+        CPPUNIT_ASSERT( tokens > 50 );
+
+        Value first, second;
+        first["id"] = 7;
+        first["tags"] = {"a", "b"};
+        second["id"] = 8;
+        const std::string two = encode(first) + encode(second);
+        ByteSpan two_span = span_of(two);
+        StreamReader<ByteSpan, UncheckedSizePolicy> two_reader(two_span);
+        UbexCursor<ByteSpan, UncheckedSizePolicy> two_cursor(two_reader);
+        CPPUNIT_ASSERT( read_id_and_tags(two_cursor) == std::make_pair(7ll, std::string("ab")) );
+        CPPUNIT_ASSERT( read_id_and_tags(two_cursor) == std::make_pair(8ll, std::string()) );
+
+        //a compile time policy is enforced just as the reader's own
+        ByteSpan shallow_span = span_of(encoded);
+        StreamReader<ByteSpan, StaticSizePolicy<2, 1024, 1024, 1024*1024>> shallow_reader(shallow_span);
+        UbexCursor<ByteSpan, StaticSizePolicy<2, 1024, 1024, 1024*1024>> shallow(shallow_reader);
+        while(shallow.next() != Token::Error)
+            CPPUNIT_ASSERT( shallow.token() != Token::End );
+        CPPUNIT_ASSERT( shallow.depth() == 0 );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Ubex_Cursor_Test );
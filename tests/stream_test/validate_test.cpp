@@ -0,0 +1,132 @@
+#include "value.hpp"
+#include "validate.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <cstring>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_validate_test = 0;
+
+class Validate_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Validate_Test );
+    CPPUNIT_TEST( test_validDocuments );
+    CPPUNIT_TEST( test_agreesWithReader );
+    CPPUNIT_TEST( test_errorOffsets );
+    CPPUNIT_TEST( test_policyLimits );
+    CPPUNIT_TEST_SUITE_END();
+
+    static ByteSpan span(const std::string& s)
+    { return ByteSpan(reinterpret_cast<const byte*>(s.data()), s.size()); }
+
+    static bool decodes(const std::string& s, const ValueSizePolicy& policy = defaultStreamReaderPolicy())
+    {
+        ByteSpan bytes = span(s);
+        BufferReader reader(bytes, policy);
+        Value v;
+        return reader.getNextValue(v);
+    }
+
+public:
+
+    void test_validDocuments()
+    {
+        Value numbers;
+        for(int i = 0; i < 5000; ++i)
+            numbers["samples"].push_back(i * 0.5);
+        for(const Value& v : {sample_document(), numbers})
+            for(bool hints : {false, true})
+            {
+                const std::string doc = encode(v, StreamWriterOptions{hints});
+                const ParseResult r = validate(span(doc));
+                CPPUNIT_ASSERT( r );
+                CPPUNIT_ASSERT( r.code == ParseError::None );
+                CPPUNIT_ASSERT_EQUAL( doc.size(), r.offset );
+
+                //the offset is where the next document starts
+                const std::string two = doc + doc;
+                CPPUNIT_ASSERT_EQUAL( doc.size(), validate(span(two)).offset );
+            }
+    }
+
+    void test_agreesWithReader()
+    {
+        const std::string doc = encode(sample_document());
+        for(std::size_t i = 0; i < doc.size(); ++i)
+        {
+            CPPUNIT_ASSERT( not validate(span(doc.substr(0, i))) );
+            for(char c : {'\0', 'I', 'K', 's', '[', ']', '(', ')', '{', '}', 'W', '\xff'})
+            {
+                std::string mutated = doc;
+                mutated[i] = c;
+                const ParseResult r = validate(span(mutated));
+                if(bool(r) == decodes(mutated))
+                    continue;
+                CPPUNIT_ASSERT( r.code == ParseError::WidthMismatch );
+            }
+        }
+    }
+
+    void test_errorOffsets()
+    {
+        //{ count:2 "a":'?'
+        const std::string unknown("{I\x02\x01" "a?", 6);
+        ParseResult r = validate(span(unknown));
+        CPPUNIT_ASSERT( r.code == ParseError::UnknownMarker );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(5), r.offset );
+        CPPUNIT_ASSERT_EQUAL( std::string("Unknown value marker encountered!"), std::string(r.message()) );
+
+        //{ count:1 "a":[ count:1 true ) }
+        const std::string unterminated("{I\x01\x01" "a[I\x01t)}", 11);
+        r = validate(span(unterminated));
+        CPPUNIT_ASSERT( r.code == ParseError::MissingEnd );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(9), r.offset );
+        CPPUNIT_ASSERT( not decodes(unterminated) );
+
+        const std::string truncated = unterminated.substr(0, 8);
+        r = validate(span(truncated));
+        CPPUNIT_ASSERT_EQUAL( std::size_t(8), r.offset );
+        CPPUNIT_ASSERT( r.code == ParseError::UnexpectedEnd );
+
+        r = validate(span(std::string("[I\x00]", 4)));
+        CPPUNIT_ASSERT( r.code == ParseError::NotAnObject );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), r.offset );
+
+        //{ W width:5 count:1 "a":true } claims a byte less than the Object takes; the reader has no objection
+        const std::string hinted("{WI\x05I\x01\x01" "at}", 10);
+        r = validate(span(hinted));
+        CPPUNIT_ASSERT( r.code == ParseError::WidthMismatch );
+        CPPUNIT_ASSERT( decodes(hinted) );
+    }
+
+    void test_policyLimits()
+    {
+        const std::string doc = encode(sample_document());
+        ValueSizePolicy policy = defaultStreamReaderPolicy();
+
+        //the document, arrays, its copies of the document, their location and its latitude nest 5 deep
+        for(std::size_t depth : {4, 5})
+        {
+            policy.max_value_depth = depth;
+            CPPUNIT_ASSERT_EQUAL( depth == 5, bool(validate(span(doc), policy)) );
+            CPPUNIT_ASSERT_EQUAL( depth == 5, decodes(doc, policy) );
+        }
+        policy = defaultStreamReaderPolicy();
+
+        policy.max_string_size = 12;
+        ParseResult r = validate(span(doc), policy);
+        CPPUNIT_ASSERT( r.code == ParseError::StringTooLarge );
+        CPPUNIT_ASSERT( not decodes(doc, policy) );
+        policy = defaultStreamReaderPolicy();
+
+        policy.max_object_size = doc.size() - 1;
+        r = validate(span(doc), policy);
+        CPPUNIT_ASSERT( r.code == ParseError::ObjectTooLarge );
+        CPPUNIT_ASSERT_EQUAL( doc.size() - 1, r.offset );
+        CPPUNIT_ASSERT( not decodes(doc, policy) );
+        policy.max_object_size = doc.size();
+        CPPUNIT_ASSERT( validate(span(doc), policy) );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Validate_Test );
@@ -0,0 +1,189 @@
+#include "value.hpp"
+#include "key_table.hpp"
+#include "event_handler.hpp"
+#include "stream_reader.hpp"
+#include "../test_utils/ubex_samples.hpp"
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace timl;
+int weird_cppunit_extern_bug_value_recycler_test = 0;
+
+namespace {
+    std::atomic<std::size_t> allocations{0};
+}
+
+//counts every heap allocation of the test binary, for test_steadyState
+void* operator new(std::size_t sz)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* p = std::malloc(sz ? sz : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+
+class Value_Recycler_Test : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( Value_Recycler_Test );
+    CPPUNIT_TEST( test_steadyState );
+    CPPUNIT_TEST( test_shapeChanges );
+    CPPUNIT_TEST( test_duplicateKeys );
+    CPPUNIT_TEST( test_keyTable );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp() override
+    {
+        messages.clear();
+        stream.clear();
+        for(int i = 0; i < 100; ++i)
+        {
+            Value message = sample_document();
+            message["seq"] = i;
+            message["note"] = "message number " + std::to_string(1000 + i) + ", well past any small string buffer";
+            message["ratio"] = i / 8.0;
+            stream += encode(message);
+            messages.push_back(std::move(message));
+        }
+    }
+private:
+    std::vector<Value> messages;
+    std::string stream;
+
+    //! what decoding \a bytes afresh gives
+    static Value fresh(const std::string& bytes)
+    {
+        ByteSpan span(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+        BufferReader reader(span);
+        Value v;
+        reader.getNextValue(v);
+        return v;
+    }
+
+public:
+
+    void test_steadyState()
+    {
+        ByteSpan span(reinterpret_cast<const byte*>(stream.data()), stream.size());
+        BufferReader reader(span);
+        reader.setRecycling(true);
+
+        Value v;
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v == messages[0] );
+
+        const std::size_t before = allocations.load();
+        for(std::size_t i = 1; i < messages.size(); ++i)
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+        const std::size_t per_message = (allocations.load() - before) / (messages.size() - 1);
+        CPPUNIT_ASSERT_EQUAL( std::size_t(0), per_message );
+        CPPUNIT_ASSERT( v == messages.back() );
+
+        //without recycling, every node is allocated again
+        ByteSpan again(reinterpret_cast<const byte*>(stream.data()), stream.size());
+        BufferReader plain(again);
+        const std::size_t plain_before = allocations.load();
+        for(std::size_t i = 0; i < messages.size(); ++i)
+        {
+            CPPUNIT_ASSERT( plain.getNextValue(v) );
+            CPPUNIT_ASSERT( v == messages[i] );
+        }
+        CPPUNIT_ASSERT( (allocations.load() - plain_before) / messages.size() > 50 );
+    }
+
+    void test_shapeChanges()
+    {
+        Value smaller = messages[3];
+        smaller.remove("surname");
+        smaller.remove("binary");
+        smaller["faves"] = {1, 2};                      //a shorter Array
+        smaller["location"] = "nowhere";                //a Map becomes a String
+        smaller["seq"] = Value::BinaryType(3, 7);       //an integer becomes a Binary
+        smaller["name"] = 'n';                          //a String becomes a Char
+        smaller["arrays"][1] = Value();
+        smaller["arrays"][2]["faves"] = "none";
+        smaller["added"]["deep"] = {"x", "y", 3.5};
+
+        Value emptied;
+        emptied["name"] = "empty";
+        emptied["faves"] = Value();                     //an Array becomes Null
+
+        std::string sequence;
+        for(const Value* message : {&messages[0], &smaller, &messages[1], &emptied, &smaller, &messages[2]})
+            sequence += encode(*message);
+        sequence += std::string("{I\x02" "\x05" "faves[I\x00]" "\x04" "nameI\x01}", 21);    //an empty Array
+
+        ByteSpan span(reinterpret_cast<const byte*>(sequence.data()), sequence.size());
+        BufferReader reader(span);
+        reader.setRecycling(true);
+        Value v;
+        for(const Value* message : {&messages[0], &smaller, &messages[1], &emptied, &smaller, &messages[2]})
+        {
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == *message );
+            CPPUNIT_ASSERT( v == fresh(encode(*message)) );
+        }
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v["faves"].isNull() );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(2), v.size() );
+        CPPUNIT_ASSERT( reader.atEnd() );
+
+        //A malformed message leaves its Value half refilled, which is as good a start as any
+        const std::string whole = encode(messages[4]);
+        const std::string broken = whole.substr(0, whole.size() / 2);
+        ByteSpan broken_span(reinterpret_cast<const byte*>(broken.data()), broken.size());
+        BufferReader recovering(broken_span);
+        recovering.setRecycling(true);
+        CPPUNIT_ASSERT( not recovering.getNextValue(v) );
+        ByteSpan rest(reinterpret_cast<const byte*>(whole.data()), whole.size());
+        BufferReader next(rest);
+        next.setRecycling(true);
+        CPPUNIT_ASSERT( next.getNextValue(v) );
+        CPPUNIT_ASSERT( v == messages[4] );
+    }
+
+    void test_duplicateKeys()
+    {
+        const std::string first("{I\x02\x01" "aI\x01\x01" "bI\x02}", 12);
+        const std::string repeated("{I\x02\x01" "aI\x01\x01" "aI\x03}", 12);
+        const std::string both = first + repeated;
+
+        ByteSpan span(reinterpret_cast<const byte*>(both.data()), both.size());
+        BufferReader reader(span);
+        reader.setRecycling(true);
+        Value v;
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v == fresh(first) );
+        CPPUNIT_ASSERT( reader.getNextValue(v) );
+        CPPUNIT_ASSERT( v == fresh(repeated) );
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), v.size() );
+        CPPUNIT_ASSERT_EQUAL( 3, v["a"].asInt() );
+    }
+
+    void test_keyTable()
+    {
+        ByteSpan span(reinterpret_cast<const byte*>(stream.data()), stream.size());
+        BufferReader reader(span);
+        reader.setRecycling(true);
+        KeyTable keys;
+        reader.setKeyTable(&keys);
+
+        Value v;
+        for(const Value& message : messages)
+        {
+            CPPUNIT_ASSERT( reader.getNextValue(v) );
+            CPPUNIT_ASSERT( v == message );
+        }
+        CPPUNIT_ASSERT( keys.size() >= messages[0].keys().size() );
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Value_Recycler_Test );
@@ -0,0 +1,34 @@
+#ifndef UBEX_SAMPLES_HPP
+#define UBEX_SAMPLES_HPP
+
+#include <string>
+#include <sstream>
+#include "value.hpp"
+#include "stream_writer.hpp"
+
+//! A document touching every type the StreamWriter emits
+inline timl::Value sample_document()
+{
+    using T = timl::Value::BinaryType::value_type;
+    timl::Value v;
+    v["name"] = "Ibrahim";
+    v["surname"] = "Onogu";
+    v["country"] = "NG";
+    v["faves"] = {453, -34, '@', true, false, -9.80665, 2.5, "So damn funny", timl::Value()};
+    v["limits"] = {-129, -32769, -2147483649ll, 255, 65535, 4294967295ull, 18446744073709551615ull};
+    v["binary"] = timl::Value::BinaryType({T(0xab), T(0xbc), T(0x00), T(0xdf)});
+    v["location"]["latitude"]["relative"] = 34.2523;
+    v["arrays"] = {v, v, v};
+    return v;
+}
+
+inline std::string encode(const timl::Value& value,
+                          timl::StreamWriterOptions options = timl::defaultStreamWriterOptions())
+{
+    std::ostringstream ss;
+    timl::StreamWriter<std::ostream> writer(ss, options);
+    writer.writeValue(value);
+    return ss.str();
+}
+
+#endif // UBEX_SAMPLES_HPP
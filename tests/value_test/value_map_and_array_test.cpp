@@ -10,6 +10,8 @@ class Value_Map_and_Array_Test : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE( Value_Map_and_Array_Test );
     CPPUNIT_TEST( test_pushBack );
     CPPUNIT_TEST( test_IndexingOperator );
+    CPPUNIT_TEST( test_emplaceAndReserve );
+    CPPUNIT_TEST( test_append );
     CPPUNIT_TEST_SUITE_END();
 public:
     using T = Value::BinaryType::value_type;
@@ -129,6 +131,60 @@ public:
         CPPUNIT_ASSERT_EQUAL( std::size_t(4), Map.size() );
     }
 
+    void test_emplaceAndReserve()
+    {
+        Value Map;
+        Map.reserve(8);
+        CPPUNIT_ASSERT( Map.isNull() );
+
+        Value& id = Map.emplace("id", Value(1));
+        CPPUNIT_ASSERT( Map.isMap() );
+        Map.reserve(100);
+        CPPUNIT_ASSERT( &id == &Map["id"] );
+        Map.emplace("id", Value(2));
+        CPPUNIT_ASSERT_EQUAL( std::size_t(1), Map.size() );
+        CPPUNIT_ASSERT_EQUAL( 2, Map["id"].asInt() );
+
+        Value Array;
+        Value& first = Array.emplace_back("first");
+        Array.reserve(100);
+        CPPUNIT_ASSERT( Array.isArray() );
+        CPPUNIT_ASSERT( &first == &Array[0] );
+        Array.emplace_back('x');
+        CPPUNIT_ASSERT( Value({"first", 'x'}) == Array );
+
+        CPPUNIT_ASSERT_THROW( Array.emplace("k", Value()), timl::value_exception );
+        Value Char(*v_char);
+        Char.reserve(4);
+        CPPUNIT_ASSERT( Char == *v_char );
+    }
+
+    void test_append()
+    {
+        Value Array({1, 2});
+        Value& second = Array[1];
+        Value Tail({"three", 'f'});
+        Value& three = Tail[0];
+        Array.append(std::move(Tail));
+        CPPUNIT_ASSERT( Value({1, 2, "three", 'f'}) == Array );
+        //the items themselves are moved over, not copied
+        CPPUNIT_ASSERT( &second == &Array[1] );
+        CPPUNIT_ASSERT( &three == &Array[2] );
+
+        Array.append(Value());
+        CPPUNIT_ASSERT_EQUAL( std::size_t(4), Array.size() );
+        Array.append(Value(5));
+        CPPUNIT_ASSERT( Value({1, 2, "three", 'f', 5}) == Array );
+
+        Value Null;
+        Null.append(Value({true, false}));
+        CPPUNIT_ASSERT( Value({true, false}) == Null );
+
+        Value Char(*v_char);
+        Char.append(Value({1, 2}));
+        CPPUNIT_ASSERT( Value({'c', 1, 2}) == Char );
+    }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( Value_Map_and_Array_Test );